@@ -0,0 +1,66 @@
+#include "Arena.h"
+
+using namespace std;
+
+Arena::~Arena()
+{
+	for (size_t i = 0; i < m_blocks.size(); i++)
+		delete[] m_blocks[i].begin;
+}
+
+void Arena::reset()
+{
+	m_block = 0;
+	if (m_blocks.empty())
+		return;
+	m_next = m_blocks[0].begin;
+	m_end = m_blocks[0].begin + m_blocks[0].size;
+}
+
+void Arena::reserve(size_t bytes)
+{
+	if (!m_blocks.empty() && m_blocks[0].size >= bytes)
+		return;
+	for (size_t i = 0; i < m_blocks.size(); i++)	//the smaller blocks go, so the big one comes first
+		delete[] m_blocks[i].begin;
+	m_blocks.clear();
+	Block b;
+	b.size = bytes;
+	b.begin = new char[b.size];
+	m_blocks.push_back(b);
+	if (m_blockSize < bytes)
+		m_blockSize = bytes;
+	reset();
+}
+
+size_t Arena::capacity() const
+{
+	size_t total = 0;
+	for (size_t i = 0; i < m_blocks.size(); i++)
+		total += m_blocks[i].size;
+	return total;
+}
+
+void* Arena::allocateSlow(size_t bytes, size_t align)
+{
+	for (size_t i = (m_blocks.empty() ? 0 : m_block + 1); i < m_blocks.size(); i++) {	//moves on to a block kept from before a reset
+		char* p = alignUp(m_blocks[i].begin, align);
+		if (p + bytes <= m_blocks[i].begin + m_blocks[i].size) {
+			m_block = i;
+			m_next = p + bytes;
+			m_end = m_blocks[i].begin + m_blocks[i].size;
+			return p;
+		}
+	}
+
+	Block b;							//each new block is twice the size of the last, so there are few of them
+	b.size = (m_blockSize > bytes + align ? m_blockSize : bytes + align);
+	b.begin = new char[b.size];
+	m_blockSize *= 2;
+	m_blocks.push_back(b);
+	m_block = m_blocks.size() - 1;
+	char* p = alignUp(b.begin, align);
+	m_next = p + bytes;
+	m_end = b.begin + b.size;
+	return p;
+}
@@ -0,0 +1,87 @@
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A region that hands out memory by bumping a pointer through large
+// blocks.  Nothing is freed on its own: reset() takes back everything at
+// once and keeps the blocks, so once an arena has grown to what a game
+// needs, later games allocate from it without touching the heap.
+class Arena
+{
+public:
+	explicit Arena(size_t blockSize = 4096) : m_blockSize(blockSize), m_block(0), m_next(nullptr), m_end(nullptr) {}
+	~Arena();
+
+	void* allocate(size_t bytes, size_t align)
+	{
+		char* p = alignUp(m_next, align);
+		if (p == nullptr || p + bytes > m_end)
+			return allocateSlow(bytes, align);
+		m_next = p + bytes;
+		return p;
+	}
+
+	// Takes back everything allocated from the arena.  Objects in it must
+	// have been destroyed first.
+	void reset();
+
+	// Makes the first block hold at least bytes, so that much can be
+	// handed out after each reset without touching the heap.  Like
+	// reset(), it must only be called with nothing in the arena.
+	void reserve(size_t bytes);
+
+	// Bytes held in blocks, used or not
+	size_t capacity() const;
+
+	// We prevent an Arena object from being copied or assigned
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+private:
+	struct Block {
+		char* begin;
+		size_t size;
+	};
+	size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	size_t m_block;				//index of the block being filled
+	char* m_next;
+	char* m_end;
+
+	static char* alignUp(char* p, size_t align)
+	{
+		return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p) + align - 1) & ~uintptr_t(align - 1));
+	}
+	void* allocateSlow(size_t bytes, size_t align);
+};
+
+// Lets standard containers allocate from an arena.  Freeing is a no-op;
+// the memory comes back when the arena is reset.
+template <typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	ArenaAllocator(Arena& arena) : m_arena(&arena) {}
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) {}
+
+	Arena* arena() const { return m_arena; }
+
+private:
+	Arena* m_arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+#endif // ARENA_INCLUDED
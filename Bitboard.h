@@ -0,0 +1,219 @@
+#ifndef BITBOARD_INCLUDED
+#define BITBOARD_INCLUDED
+
+#include "globals.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// A set of board cells, one bit per cell.  Each row is packed into
+// wordsPerRow() 64-bit words, so column c of row r is bit c % 64 of word
+// c / 64 of that row.  Bits past the last column are always zero.
+class Bitboard
+{
+public:
+	Bitboard() : m_rows(0), m_cols(0), m_words(0) {}
+	Bitboard(int rows, int cols) { resize(rows, cols); }
+
+	// Resizes the board and empties it
+	void resize(int rows, int cols)
+	{
+		m_rows = rows;
+		m_cols = cols;
+		m_words = (cols + 63) / 64;
+		m_bits.assign(size_t(rows) * m_words, 0);
+	}
+	void clear() { m_bits.assign(m_bits.size(), 0); }
+	// Puts every cell of the board in the set
+	void fill()
+	{
+		for (int r = 0; r < m_rows; r++)
+			for (int w = 0; w < m_words; w++)
+				row(r)[w] = wordMask(w);
+	}
+
+	int rows() const { return m_rows; }
+	int cols() const { return m_cols; }
+	int wordsPerRow() const { return m_words; }
+	uint64_t* row(int r) { return &m_bits[size_t(r) * m_words]; }
+	const uint64_t* row(int r) const { return &m_bits[size_t(r) * m_words]; }
+	size_t bytes() const { return m_bits.capacity() * sizeof(uint64_t); }
+
+	// Returns the bits of word w of a row that correspond to real columns
+	uint64_t wordMask(int w) const
+	{
+		int valid = m_cols - 64 * w;
+		return valid >= 64 ? ~uint64_t(0) : (uint64_t(1) << valid) - 1;
+	}
+
+	bool test(int r, int c) const { return (row(r)[c >> 6] >> (c & 63)) & 1; }
+	void set(int r, int c) { row(r)[c >> 6] |= uint64_t(1) << (c & 63); }
+	void reset(int r, int c) { row(r)[c >> 6] &= ~(uint64_t(1) << (c & 63)); }
+
+	// Returns true if any cell of a ship of the given length whose top or
+	// left end is at (r, c) is in the set.  The ship must be on the board.
+	bool anyInRun(int r, int c, int length, Direction dir) const
+	{
+		if (dir == VERTICAL) {
+			for (int i = 0; i < length; i++)
+				if (test(r + i, c))
+					return true;
+			return false;
+		}
+		const uint64_t* w = row(r);
+		for (int end = c + length; c < end; ) {		//checks a word at a time
+			int n = 64 - (c & 63);
+			if (n > end - c)
+				n = end - c;
+			if (w[c >> 6] & runMask(c & 63, n))
+				return true;
+			c += n;
+		}
+		return false;
+	}
+
+	void setRun(int r, int c, int length, Direction dir) { changeRun(r, c, length, dir, true); }
+	void resetRun(int r, int c, int length, Direction dir) { changeRun(r, c, length, dir, false); }
+
+	// Sets out to the cells where a ship of the given length could have its
+	// top or left end with every one of its cells in this set
+	void runStarts(int length, Direction dir, Bitboard& out) const
+	{
+		out = *this;
+		for (int span = 1; span < length; ) {		//doubles the length of the runs checked each pass
+			int step = (span < length - span ? span : length - span);
+			if (dir == HORIZONTAL)
+				for (int r = 0; r < m_rows; r++)
+					andShiftedRow(out.row(r), step);
+			else
+				for (int r = 0; r < m_rows; r++)
+					for (int w = 0; w < m_words; w++)
+						out.row(r)[w] &= (r + step < m_rows ? out.row(r + step)[w] : 0);
+			span += step;
+		}
+	}
+
+	long long count() const
+	{
+		long long n = 0;
+		for (size_t i = 0; i < m_bits.size(); i++)
+			n += popCount(m_bits[i]);
+		return n;
+	}
+
+	// Sets (r, c) to the n-th cell in the set in row-major order, counting
+	// from 0, or returns false if the set has n or fewer cells
+	bool nth(long long n, int& r, int& c) const
+	{
+		for (size_t i = 0; i < m_bits.size(); i++) {
+			int k = popCount(m_bits[i]);
+			if (n >= k) {
+				n -= k;
+				continue;
+			}
+			uint64_t w = m_bits[i];
+			for (; n > 0; n--)
+				w &= w - 1;			//clears the lowest set bit
+			r = int(i / m_words);
+			c = int(i % m_words) * 64 + lowestBit(w);
+			return true;
+		}
+		return false;
+	}
+
+	bool any() const
+	{
+		for (size_t i = 0; i < m_bits.size(); i++)
+			if (m_bits[i] != 0)
+				return true;
+		return false;
+	}
+
+	Bitboard& operator|=(const Bitboard& o)
+	{
+		for (size_t i = 0; i < m_bits.size(); i++)
+			m_bits[i] |= o.m_bits[i];
+		return *this;
+	}
+
+	Bitboard& operator&=(const Bitboard& o)
+	{
+		for (size_t i = 0; i < m_bits.size(); i++)
+			m_bits[i] &= o.m_bits[i];
+		return *this;
+	}
+
+	// Removes the cells in o from the set
+	Bitboard& andNot(const Bitboard& o)
+	{
+		for (size_t i = 0; i < m_bits.size(); i++)
+			m_bits[i] &= ~o.m_bits[i];
+		return *this;
+	}
+
+	static int popCount(uint64_t w)
+	{
+#if defined(__GNUC__)
+		return __builtin_popcountll(w);
+#else
+		int n = 0;
+		for (; w != 0; w &= w - 1)
+			n++;
+		return n;
+#endif
+	}
+
+	static int lowestBit(uint64_t w)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctzll(w);
+#else
+		int n = 0;
+		for (; (w & 1) == 0; w >>= 1)
+			n++;
+		return n;
+#endif
+	}
+
+private:
+	int m_rows, m_cols, m_words;
+	std::vector<uint64_t> m_bits;
+
+	// Clears each bit of the row whose column + k is not set, treating the
+	// columns past the end of the row as unset
+	void andShiftedRow(uint64_t* w, int k) const
+	{
+		int words = k >> 6, bits = k & 63;
+		for (int i = 0; i < m_words; i++) {
+			uint64_t lo = (i + words < m_words ? w[i + words] : 0);
+			uint64_t hi = (i + words + 1 < m_words ? w[i + words + 1] : 0);
+			w[i] &= (bits == 0 ? lo : (lo >> bits) | (hi << (64 - bits)));
+		}
+	}
+
+	static uint64_t runMask(int first, int n)
+	{
+		return (n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1) << first;
+	}
+
+	void changeRun(int r, int c, int length, Direction dir, bool on)
+	{
+		if (dir == VERTICAL) {
+			for (int i = 0; i < length; i++)
+				on ? set(r + i, c) : reset(r + i, c);
+			return;
+		}
+		uint64_t* w = row(r);
+		for (int end = c + length; c < end; ) {
+			int n = 64 - (c & 63);
+			if (n > end - c)
+				n = end - c;
+			if (on)
+				w[c >> 6] |= runMask(c & 63, n);
+			else w[c >> 6] &= ~runMask(c & 63, n);
+			c += n;
+		}
+	}
+};
+
+#endif // BITBOARD_INCLUDED
@@ -1,7 +1,10 @@
 #include "Board.h"
+#include "Bitboard.h"
+#include "Grid.h"
 #include "Game.h"
 #include "globals.h"
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -17,78 +20,70 @@ public:
 	void display(bool shotsOnly) const;
 	bool attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId);
 	bool allShipsDestroyed() const;
+	void takenCells(Bitboard& out) const;
+	bool shipPlacement(int shipId, Point& topOrLeft, Direction& dir) const;
 	bool isValidPlacement(int r, int c, int length, Direction dir);
 	~BoardImpl();
 
 private:
 	const Game& m_game;
-	char m_grid[MAXROWS][MAXCOLS];
+	Bitboard m_ships;		//cells occupied by a ship
+	Bitboard m_shots;		//cells that have been attacked; hits are the shots that are also ship cells
+	Bitboard m_blocked;		//cells blocked by block()
 	struct Ships {
 		int r, c;
-		string m_name;
 		Direction m_dir;
-		int health, ID;
-		char m_symbol;
-		Ships* next;
+		int health;
+		bool placed;
 	};
-	int shipsLeft;
-	Ships* head;
+	vector<Ships> m_shipList;		//indexed by ship ID
+	int m_cellsLeft;				//ship cells that have not been hit
+	enum { NOSHIP = 255 };
+	Grid<unsigned char> m_shipAt;	//ID of the ship occupying each cell, or NOSHIP
 };
 
-BoardImpl::BoardImpl(const Game& g) : m_game(g)
+BoardImpl::BoardImpl(const Game& g)
+	: m_game(g), m_ships(g.rows(), g.cols()), m_shots(g.rows(), g.cols()), m_blocked(g.rows(), g.cols()),
+	m_shipList(g.nShips()), m_cellsLeft(0), m_shipAt(g.rows(), g.cols(), NOSHIP)
 {
-
-	head = nullptr;					//intialize linked list to empty
-	shipsLeft = m_game.nShips();
-
-	for (int i = 0; i < g.rows(); i++)			//populate board with dots
-		for (int j = 0; j < g.cols(); j++)
-			m_grid[i][j] = '.';
-
+	for (size_t i = 0; i < m_shipList.size(); i++)
+		m_shipList[i].placed = false;
 }
 
 BoardImpl::~BoardImpl() {
-	while (head != nullptr) {		//delete any dynamically allocated ships in linked list
-		Ships* ptr = head;
-		head = head->next;
-		delete ptr;
-	}
 }
 
 void BoardImpl::clear()
 {
-	for (int r = 0; r < m_game.rows(); r++)				//clears board with dots
-		for (int c = 0; c < m_game.cols(); c++)
-			m_grid[r][c] = '.';
-
+	m_shipList.resize(m_game.nShips());			//the game may have gained ships since the board was made
+	for (size_t i = 0; i < m_shipList.size(); i++)	//empties board of ships, shots and blocked cells
+		m_shipList[i].placed = false;
+	m_shipAt.fill(NOSHIP);
+	m_ships.clear();
+	m_shots.clear();
+	m_blocked.clear();
+	m_cellsLeft = 0;
 }
 
 void BoardImpl::block()
 {
-	// Block cells with 50% probability
+	// Block cells with 50% probability, taking 64 random bits at a time
+	Rng& rng = m_game.rng();
 	for (int r = 0; r < m_game.rows(); r++)
-		for (int c = 0; c < m_game.cols(); c++)
-			if (randInt(2) == 0)
-			{
-				m_grid[r][c] = 'X'; // blocks corresponding cell
-			}
+		for (int w = 0; w < m_blocked.wordsPerRow(); w++)
+			m_blocked.row(r)[w] |= rng.next() & m_blocked.wordMask(w);
 }
 
 void BoardImpl::unblock()
 {
-	for (int r = 0; r < m_game.rows(); r++)
-		for (int c = 0; c < m_game.cols(); c++)
-		{
-			if (m_grid[r][c] == 'X')
-				m_grid[r][c] = '.'; // unblocks any previously blocked cells
-		}
+	m_blocked.clear(); // unblocks any previously blocked cells
 }
 
 bool BoardImpl::placeShip(Point topOrLeft, int shipId, Direction dir)
 {
-	int length = m_game.shipLength(shipId);
-	if (length == -1)						//checks for invalid ship
+	if (shipId < 0 || shipId >= int(m_shipList.size()))		//checks for invalid ship
 		return false;
+	int length = m_game.shipLength(shipId);
 	int r = topOrLeft.r;
 	int c = topOrLeft.c;
 	if (r < 0 || c < 0 || r >= m_game.rows() || c >= m_game.cols())		//checks for invalid placement
@@ -103,88 +98,54 @@ bool BoardImpl::placeShip(Point topOrLeft, int shipId, Direction dir)
 	if (!isValidPlacement(r, c, length, dir))					//calls function to determine if ship will fit at desired location
 		return false;
 
-	string name = m_game.shipName(shipId);
-	for (Ships* ptr = head; ptr != nullptr; ptr = ptr->next) {			//checks for duplicate ships
-		if (ptr->m_name == name)
-			return false;
-	}
-
-	Ships* p = new Ships;			//creats new node in linked list for this ship to occupy
-	p->c = c;
-	p->r = r;
-	p->m_name = name;
-	p->next = head;
-	p->m_dir = dir;
-	p->health = length;
-	p->ID = shipId;
-	head = p;
-
-	char symbol = m_game.shipSymbol(shipId);
-	p->m_symbol = symbol;
-
-	if (dir == HORIZONTAL) {					//replaces dots on board with ship symbol
-		for (int i = 0; i < length; i++)
-			m_grid[r][c + i] = symbol;
-	}
+	Ships& s = m_shipList[shipId];
+	if (s.placed)					//checks for duplicate ships
+		return false;
 
-	if (dir == VERTICAL) {
-		for (int i = 0; i < length; i++)
-			m_grid[r + i][c] = symbol;
+	s.placed = true;				//records the ship in its slot
+	s.c = c;
+	s.r = r;
+	s.m_dir = dir;
+	s.health = length;
+
+	m_ships.setRun(r, c, length, dir);		//marks the ship's cells as occupied
+	m_cellsLeft += length;
+	for (int i = 0; i < length; i++) {
+		if (dir == HORIZONTAL)
+			m_shipAt(r, c + i) = shipId;
+		else m_shipAt(r + i, c) = shipId;
 	}
 
 	return true;
 }
 
 bool BoardImpl::isValidPlacement(int r, int c, int length, Direction dir) {
-	if (dir == HORIZONTAL) {							//checks each point that the ship would occupy if placed at a given location and returns false if any point is not a dot
-		for (int i = 0; i < length; i++)
-			if (m_grid[r][c + i] != '.')
-				return false;
-	}
-	else if (dir == VERTICAL) {
-		for (int i = 0; i < length; i++)
-			if (m_grid[r + i][c] != '.')
-				return false;
-	}
-
-	return true;
+	//a ship fits if none of its cells is occupied, blocked or already attacked
+	return !m_ships.anyInRun(r, c, length, dir) && !m_blocked.anyInRun(r, c, length, dir) &&
+		!m_shots.anyInRun(r, c, length, dir);
 }
 
 bool BoardImpl::unplaceShip(Point topOrLeft, int shipId, Direction dir)
 {
-	int length = m_game.shipLength(shipId); //checks for invalid ship
-	if (length == -1)
+	if (shipId < 0 || shipId >= int(m_shipList.size()))		//checks for invalid ship
 		return false;
 
-	string nm = m_game.shipName(shipId);
-	Ships* ptr = head;
-	Ships* ptr2 = head;
-	for (; ptr != nullptr && ptr->m_name != nm; ptr = ptr->next)	//loops until ptr points to target ship
-		ptr2 = ptr;													//ptr2 points to one node behind ptr
-
-	if (ptr == nullptr)			//return false if ship not found
+	Ships& s = m_shipList[shipId];
+	if (!s.placed)			//return false if ship not found
 		return false;
 
-	if (topOrLeft.c != ptr->c || topOrLeft.r != ptr->r || dir != ptr->m_dir)	//return false if indicated point or direction is incorrect
+	if (topOrLeft.c != s.c || topOrLeft.r != s.r || dir != s.m_dir)	//return false if indicated point or direction is incorrect
 		return false;
 
-	if (dir == HORIZONTAL) {									//replace ship symbol on board with dots
-		for (int i = 0; i < length; i++) {
-			m_grid[topOrLeft.r][topOrLeft.c + i] = '.';
-		}
-	}
-
-	if (dir == VERTICAL) {
-		for (int i = 0; i < length; i++) {
-			m_grid[topOrLeft.r + i][topOrLeft.c] = '.';
-		}
+	int length = m_game.shipLength(shipId);
+	m_ships.resetRun(s.r, s.c, length, dir);		//frees the ship's cells
+	m_cellsLeft -= length;
+	for (int i = 0; i < length; i++) {
+		if (dir == HORIZONTAL)
+			m_shipAt(s.r, s.c + i) = NOSHIP;
+		else m_shipAt(s.r + i, s.c) = NOSHIP;
 	}
-
-	if (ptr2 == head)					//removes ship node from linked list
-		head = ptr->next;
-	else ptr2->next = ptr->next;
-
-	delete ptr;
+	s.placed = false;
 
 	return true;
 }
@@ -193,38 +154,24 @@ void BoardImpl::display(bool shotsOnly) const
 {
 	int c = m_game.cols();
 
-	if (!shotsOnly) {
-		cout << "  ";
-		for (int i = 0; i < c; i++)				//prints out numbered columns
-			cout << i;
-
-		cout << endl;
-
-		for (int j = 0; j < m_game.rows(); j++) {
-			cout << j << " ";
-			for (int i = 0; i < c; i++) {
-				cout << m_grid[j][i];				//prints out numbered row and board grid
-			}
-			cout << endl;
+	cout << "  ";
+	for (int i = 0; i < c; i++)				//prints out numbered columns
+		cout << i % 10;
+
+	cout << endl;
+
+	for (int j = 0; j < m_game.rows(); j++) {
+		cout << j << " ";
+		for (int i = 0; i < c; i++) {
+			if (m_blocked.test(j, i) || (m_shots.test(j, i) && m_ships.test(j, i)))
+				cout << 'X';
+			else if (m_shots.test(j, i))
+				cout << 'o';
+			else if (!shotsOnly && m_shipAt(j, i) != NOSHIP)	//ship symbols are only shown if shotsOnly is false
+				cout << m_game.shipSymbol(m_shipAt(j, i));
+			else cout << '.';
 		}
-	}
-
-	if (shotsOnly) {
-		cout << "  ";
-		for (int i = 0; i < c; i++)
-			cout << i;
-
 		cout << endl;
-
-		for (int j = 0; j < m_game.rows(); j++) {
-			cout << j << " ";
-			for (int i = 0; i < c; i++) {
-				if (m_grid[j][i] != 'X' && m_grid[j][i] != '.' && m_grid[j][i] != 'o') //same as above except ship symbols are replaced with dots
-					cout << '.';
-				else cout << m_grid[j][i];
-			}
-			cout << endl;
-		}
 	}
 
 }
@@ -236,45 +183,46 @@ bool BoardImpl::attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId)
 		shipDestroyed = false;
 		return false;
 	}
-	if (m_grid[p.r][p.c] == 'o' || m_grid[p.r][p.c] == 'X') { //checks for already targeted location
+	if (m_shots.test(p.r, p.c) || m_blocked.test(p.r, p.c)) { //checks for already targeted location
 		shotHit = false;
 		shipDestroyed = false;
 		return false;
 	}
 
-	if (m_grid[p.r][p.c] != '.') {						//if shot is not a dot, it hit a ship
-		char sym = m_grid[p.r][p.c];
-		m_grid[p.r][p.c] = 'X';
-		shotHit = true;
-		for (Ships* ptr = head; ptr != nullptr; ptr = ptr->next) {	//finds corresponding ship based coordinate symbol
-			if (ptr->m_symbol == sym) {
-				ptr->health--;										//decrements ships health
-				if (ptr->health == 0) {
-					shipDestroyed = true;							//checks if ship is destroyed
-					shipsLeft--;
-					shipId = ptr->ID;
-				}
-				else shipDestroyed = false;
-
-				break;
-			}
+	m_shots.set(p.r, p.c);
+	shipDestroyed = false;
+	shotHit = m_ships.test(p.r, p.c);
+	if (shotHit) {
+		m_cellsLeft--;
+		int id = m_shipAt(p.r, p.c);		//looks up the ship occupying the cell
+		if (--m_shipList[id].health == 0) {	//decrements ships health and checks if ship is destroyed
+			shipDestroyed = true;
+			shipId = id;
 		}
 	}
-	else {							//if shot missed, update board with 'o'
-		shotHit = false;
-		shipDestroyed = false;
-		m_grid[p.r][p.c] = 'o';
-	}
 
 	return true;
 }
 
 bool BoardImpl::allShipsDestroyed() const	//returns true if a board has no surviving ship
 {
-	if (shipsLeft == 0)
-		return true;
+	return m_cellsLeft == 0;
+}
+
+void BoardImpl::takenCells(Bitboard& out) const		//the cells a ship placed now could not use
+{
+	out = m_ships;
+	out |= m_blocked;
+	out |= m_shots;
+}
 
-	return false;
+bool BoardImpl::shipPlacement(int shipId, Point& topOrLeft, Direction& dir) const
+{
+	if (shipId < 0 || shipId >= int(m_shipList.size()) || !m_shipList[shipId].placed)
+		return false;
+	topOrLeft = Point(m_shipList[shipId].r, m_shipList[shipId].c);
+	dir = m_shipList[shipId].m_dir;
+	return true;
 }
 
 //******************** Board functions ********************************
@@ -332,3 +280,12 @@ bool Board::allShipsDestroyed() const
 	return m_impl->allShipsDestroyed();
 }
 
+void Board::takenCells(Bitboard& out) const
+{
+	m_impl->takenCells(out);
+}
+
+bool Board::shipPlacement(int shipId, Point& topOrLeft, Direction& dir) const
+{
+	return m_impl->shipPlacement(shipId, topOrLeft, dir);
+}
@@ -5,12 +5,15 @@
 
 class Game;
 class BoardImpl;
+class Bitboard;
 
 class Board
 {
 public:
 	Board(const Game& g);
 	~Board();
+	// Empties the board of ships, shots and blocked cells, keeping its
+	// storage, so one board can be reused for any number of games
 	void clear();
 	void block();
 	void unblock();
@@ -19,6 +22,11 @@ public:
 	void display(bool shotsOnly) const;
 	bool attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId);
 	bool allShipsDestroyed() const;
+	// Sets out to the cells that are occupied, blocked or attacked
+	void takenCells(Bitboard& out) const;
+	// Sets topOrLeft and dir to where the ship is, or returns false if it
+	// is not on the board
+	bool shipPlacement(int shipId, Point& topOrLeft, Direction& dir) const;
 	// We prevent a Board object from being copied or assigned
 	Board(const Board&) = delete;
 	Board& operator=(const Board&) = delete;
@@ -0,0 +1,56 @@
+#include "CellSampler.h"
+
+void CellSampler::reset(int rows, int cols)
+{
+	m_rows = rows;
+	m_cols = cols;
+	m_size = rows * cols;
+	m_cells.resize(m_size);
+	m_slot.resize(m_size);
+	for (int i = 0; i < m_size; i++) {
+		m_cells[i] = i;
+		m_slot[i] = i;
+	}
+}
+
+void CellSampler::remove(int r, int c)
+{
+	int cell = r * m_cols + c;
+	int slot = m_slot[cell];
+	if (slot < 0)
+		return;
+	int last = m_cells[--m_size];		//moves the last remaining cell into the freed slot
+	m_cells[slot] = last;
+	m_slot[last] = slot;
+	m_slot[cell] = -1;
+}
+
+bool CellSampler::sampleInRow(int r, int cLo, int cHi, Rng& rng, Point& p) const
+{
+	int count = 0;
+	for (int c = cLo; c <= cHi; c++)		//counts the candidates, then picks one of them
+		count += contains(r, c);
+	if (count == 0)
+		return false;
+	int pick = rng.nextInt(count);
+	for (int c = cLo; ; c++)
+		if (contains(r, c) && pick-- == 0) {
+			p = Point(r, c);
+			return true;
+		}
+}
+
+bool CellSampler::sampleInCol(int c, int rLo, int rHi, Rng& rng, Point& p) const
+{
+	int count = 0;
+	for (int r = rLo; r <= rHi; r++)
+		count += contains(r, c);
+	if (count == 0)
+		return false;
+	int pick = rng.nextInt(count);
+	for (int r = rLo; ; r++)
+		if (contains(r, c) && pick-- == 0) {
+			p = Point(r, c);
+			return true;
+		}
+}
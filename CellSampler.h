@@ -0,0 +1,44 @@
+#ifndef CELLSAMPLER_INCLUDED
+#define CELLSAMPLER_INCLUDED
+
+#include "globals.h"
+#include <vector>
+
+// The set of cells a player has not attacked yet.  The cells are kept in a
+// dense array with a map from each cell to its slot, so removing a cell
+// (swap it with the last one) and drawing a uniformly random cell are
+// both O(1).
+class CellSampler
+{
+public:
+	CellSampler() : m_rows(0), m_cols(0), m_size(0) {}
+	CellSampler(int rows, int cols) { reset(rows, cols); }
+
+	// Makes every cell of a rows x cols board available again
+	void reset(int rows, int cols);
+
+	int size() const { return m_size; }
+	bool contains(int r, int c) const { return m_slot[r * m_cols + c] >= 0; }
+	void remove(int r, int c);
+
+	// Returns a uniformly random remaining cell; the set must not be empty
+	Point sample(Rng& rng) const
+	{
+		int cell = m_cells[rng.nextInt(m_size)];
+		return Point(cell / m_cols, cell % m_cols);
+	}
+
+	// Sets p to a uniformly random remaining cell of row r with a column
+	// from cLo to cHi, or returns false if there is none.  The cost is
+	// proportional to the width of the window.
+	bool sampleInRow(int r, int cLo, int cHi, Rng& rng, Point& p) const;
+	// The same for column c with a row from rLo to rHi
+	bool sampleInCol(int c, int rLo, int rHi, Rng& rng, Point& p) const;
+
+private:
+	int m_rows, m_cols, m_size;
+	std::vector<int> m_cells;	//the remaining cells, as r * cols + c, in the first m_size slots
+	std::vector<int> m_slot;	//slot of each cell in m_cells, or -1 once removed
+};
+
+#endif // CELLSAMPLER_INCLUDED
@@ -0,0 +1,533 @@
+#include "CompactGame.h"
+#include "Bitboard.h"
+#include "Game.h"
+#include "globals.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+	inline int popCount(uint64_t w)
+	{
+#if defined(__GNUC__)
+		return __builtin_popcountll(w);
+#else
+		int n = 0;
+		for (; w != 0; w &= w - 1)
+			n++;
+		return n;
+#endif
+	}
+
+	// The cells of the board not in shots
+	CellMask openCells(const CompactFleet& f, const CellMask& shots)
+	{
+		CellMask open = shots;		//the unattacked cells are the complement of the shots
+		open.w[0] = ~open.w[0];
+		open.w[1] = ~open.w[1];
+		if (f.cells < 128)
+			open.w[f.cells >> 6] &= (uint64_t(1) << (f.cells & 63)) - 1;
+		if (f.cells <= 64)
+			open.w[1] = 0;
+		return open;
+	}
+
+	const int PLACETRIES = 50;			//boards a mediocre player blocks before giving up, as MediocrePlayer does
+
+	// Whether (r, c) is on the board and not yet shot
+	inline bool isOpen(const CompactFleet& f, const CellMask& shots, int r, int c)
+	{
+		return r >= 0 && c >= 0 && r < f.rows && c < f.cols && !shots.test(r * f.cols + c);
+	}
+
+	// Adds the placements of a ship of the given length lying on the n
+	// open cells from cell on with the given step to the density of each
+	// cell they cover; the count for offset i is min(i + 1, n - i, length,
+	// n - length + 1), as in PlacementDensity
+	void addRunDensity(int* density, int cell, int step, int n, int length)
+	{
+		if (length > n)
+			return;
+		int fit = min(length, n - length + 1);
+		for (int i = 0; i < n; i++)
+			density[cell + i * step] += min(min(i + 1, n - i), fit);
+	}
+}
+
+int CellMask::count() const
+{
+	return popCount(w[0]) + popCount(w[1]);
+}
+
+int CellMask::nth(int n) const
+{
+	for (int i = 0; i < 2; i++) {
+		int k = popCount(w[i]);
+		if (n >= k) {
+			n -= k;
+			continue;
+		}
+		uint64_t bits = w[i];
+		for (; n > 0; n--)				//drops the lower members
+			bits &= bits - 1;
+		return 64 * i + Bitboard::lowestBit(bits);
+	}
+	return -1;
+}
+
+bool CompactFleet::set(const Game& g)
+{
+	if (g.rows() * g.cols() > MAXCELLS || g.nShips() > MAXSHIPS)
+		return false;
+	rows = g.rows();
+	cols = g.cols();
+	cells = rows * cols;
+	nShips = g.nShips();
+	for (int k = 0; k < nShips; k++)
+		length[k] = uint8_t(g.shipLength(k));
+	return true;
+}
+
+void CompactBoard::clear()
+{
+	ships.clear();
+	shots.clear();
+	vertical = 0;
+	cellsLeft = 0;
+}
+
+bool CompactBoard::placeShip(const CompactFleet& f, int shipId, int cell, bool isVertical)
+{
+	int length = f.length[shipId];
+	int r = cell / f.cols, c = cell % f.cols;
+	if (isVertical ? r + length > f.rows : c + length > f.cols)
+		return false;
+	int step = (isVertical ? f.cols : 1);
+	for (int i = 0; i < length; i++)
+		if (ships.test(cell + i * step))
+			return false;
+	for (int i = 0; i < length; i++)
+		ships.set(cell + i * step);
+	start[shipId] = uint8_t(cell);
+	health[shipId] = uint8_t(length);
+	if (isVertical)
+		vertical |= uint8_t(1 << shipId);
+	else vertical &= uint8_t(~(1 << shipId));
+	cellsLeft += uint8_t(length);
+	return true;
+}
+
+bool CompactBoard::attack(const CompactFleet& f, int cell, bool& shotHit, bool& shipDestroyed, int& shipId)
+{
+	shotHit = false;
+	shipDestroyed = false;
+	if (cell < 0 || cell >= f.cells || shots.test(cell))
+		return false;
+	shots.set(cell);
+	if (!ships.test(cell))
+		return true;
+	shotHit = true;
+	cellsLeft--;
+	int r = cell / f.cols, c = cell % f.cols;
+	for (int k = 0; k < f.nShips; k++) {		//finds the ship through the cell
+		int sr = start[k] / f.cols, sc = start[k] % f.cols;
+		bool covers = ((vertical >> k) & 1) ? (c == sc && r >= sr && r < sr + f.length[k])
+			: (r == sr && c >= sc && c < sc + f.length[k]);
+		if (!covers)
+			continue;
+		if (--health[k] == 0) {
+			shipDestroyed = true;
+			shipId = k;
+		}
+		break;
+	}
+	return true;
+}
+
+int CompactTargets::find(int targetId, int& last) const
+{
+	last = -1;
+	for (int t = nTargets - 1; t >= 0; t--) {		//newest first, as GoodPlayer searches
+		last = id[t];
+		if (id[t] == targetId)
+			return t;
+	}
+	return -1;
+}
+
+int CompactTargets::add(int targetId)
+{
+	if (nTargets == MAXTARGETS)
+		compact();
+	if (nTargets == MAXTARGETS)
+		return -1;
+	id[nTargets] = int8_t(targetId);
+	destroyed &= uint16_t(~(1 << nTargets));
+	return nTargets++;
+}
+
+int CompactTargets::hitsOf(int target, int* out) const
+{
+	int n = 0;
+	for (int i = 0; i < nHits; i++)
+		if (owner(i) == target)
+			out[n++] = i;
+	return n;
+}
+
+void CompactTargets::addHit(int targetId, int c)
+{
+	if (nHits == MAXHITS)
+		compact();
+	int last;
+	int target = find(targetId, last);
+	if (nHits == MAXHITS || target < 0)
+		return;
+	hit[nHits++] = uint16_t(c | target << OWNERSHIFT);
+}
+
+void CompactTargets::compact()
+{
+	int newIndex[MAXTARGETS];
+	bool shadowed[MAXTARGETS];
+	for (int t = 0; t < nTargets; t++) {
+		shadowed[t] = false;
+		for (int u = t + 1; u < nTargets && !shadowed[t]; u++)
+			shadowed[t] = (id[u] == id[t]);
+	}
+	// A shadowed target is never destroyed after, so one not destroyed
+	// hides every older target from the search for one to take up
+	int n = 0;
+	uint16_t keptDestroyed = 0;
+	bool hidden = false;
+	for (int t = nTargets - 1; t >= 0; t--) {
+		bool isDestroyed = (destroyed >> t) & 1;
+		if (shadowed[t] && (isDestroyed || hidden) && t > 0) {		//the oldest still gives the next new target its ID
+			newIndex[t] = -1;
+			continue;
+		}
+		hidden = hidden || (shadowed[t] && !isDestroyed);
+		newIndex[t] = n++;
+	}
+	for (int t = 0; t < nTargets; t++) {		//numbers the kept targets oldest first
+		if (newIndex[t] < 0)
+			continue;
+		newIndex[t] = n - 1 - newIndex[t];
+		id[newIndex[t]] = id[t];
+		keptDestroyed |= uint16_t(((destroyed >> t) & 1) << newIndex[t]);
+	}
+	int m = 0;
+	for (int i = 0; i < nHits; i++)
+		if (!shadowed[owner(i)])
+			hit[m++] = uint16_t((hit[i] & ~(15 << OWNERSHIFT)) | newIndex[owner(i)] << OWNERSHIFT);
+	nTargets = uint8_t(n);
+	destroyed = keptDestroyed;
+	nHits = uint8_t(m);
+}
+
+void CompactPlayer::reset(Kind k, uint64_t seed)
+{
+	rng.reseed(seed);
+	kind = uint8_t(k);
+	state = 1;
+	lastCell = (k == AWFUL ? 0 : uint8_t(NOCELL));
+	target = -1;
+	gone = 0;
+	targets.clear();
+}
+
+bool CompactPlayer::placeShips(const CompactFleet& f, CompactBoard& b, CompactPlacer& scratch)
+{
+	b.clear();
+	if (kind == AWFUL) {			//the same clustered layout as AwfulPlayer
+		for (int k = 0; k < f.nShips; k++)
+			if (k >= f.rows || !b.placeShip(f, k, k * f.cols, false))
+				return false;
+		return true;
+	}
+
+	scratch.lengths.assign(f.length, f.length + f.nShips);
+	vector<ShipPlacement>& layout = scratch.layout;
+	FleetPlacer& placer = scratch.placer;
+	bool placed = false;
+	if (kind == GOOD) {				//as placeFleetRandomly does
+		placer.setBoard(f.rows, f.cols);
+		FleetPlacer::Result result = placer.placeUniform(scratch.lengths, rng, layout, 100);
+		if (result == FleetPlacer::GAVE_UP)
+			result = placer.place(scratch.lengths, rng, layout);
+		placed = (result == FleetPlacer::PLACED);
+	}
+	else {
+		Bitboard& taken = scratch.taken;
+		if (taken.rows() != f.rows || taken.cols() != f.cols)
+			taken.resize(f.rows, f.cols);
+		for (int tries = 0; tries < PLACETRIES && !placed; tries++) {		//blocks half the cells and searches the rest, as Board::block does
+			for (int r = 0; r < f.rows; r++)
+				for (int w = 0; w < taken.wordsPerRow(); w++)
+					taken.row(r)[w] = rng.next() & taken.wordMask(w);
+			placer.setBoard(f.rows, f.cols);
+			placer.setTaken(taken);
+			placed = (placer.solve(scratch.lengths, layout, 100000) == FleetPlacer::PLACED);
+		}
+	}
+	if (!placed)
+		return false;
+	for (int k = 0; k < f.nShips; k++) {
+		Point p = layout[k].topOrLeft;
+		if (!b.placeShip(f, k, p.r * f.cols + p.c, layout[k].dir == VERTICAL))
+			return false;
+	}
+	return true;
+}
+
+int CompactPlayer::recommendAttack(const CompactFleet& f, const CompactBoard& target)
+{
+	if (kind == AWFUL) {			//walks backward through the cells, as AwfulPlayer does
+		lastCell = uint8_t((lastCell + f.cells - 1) % f.cells);
+		return lastCell;
+	}
+	if (kind == GOOD)
+		return goodAttack(f, target.shots);
+
+	return mediocreAttack(f, rng, state, lastCell, target.shots);
+}
+
+void CompactPlayer::recordAttackResult(const CompactFleet& f, int cell, bool validShot, bool shotHit, bool shipDestroyed,
+	int shipId)
+{
+	if (kind == MEDIOCRE)
+		mediocreRecord(state, lastCell, cell, validShot, shotHit, shipDestroyed);
+	else if (kind == GOOD && validShot && shotHit)
+		goodRecord(f, cell, shipDestroyed, shipId);
+}
+
+// GoodPlayer::findSpot on the packed state.  The densities are those of
+// the ships still counted on the unattacked cells, worked out afresh.
+int CompactPlayer::goodAttack(const CompactFleet& f, const CellMask& shots)
+{
+	if (state == 1) {				//fires at the first cell of highest density
+		int density[CompactFleet::MAXCELLS] = { 0 };
+		for (int k = 0; k < f.nShips; k++) {
+			if ((gone >> k) & 1)
+				continue;
+			for (int r = 0; r < f.rows; r++)			//each row's runs of open cells
+				for (int c = 0; c < f.cols; ) {
+					int n = 0;
+					while (c + n < f.cols && !shots.test(r * f.cols + c + n))
+						n++;
+					addRunDensity(density, r * f.cols + c, 1, n, f.length[k]);
+					c += n + 1;
+				}
+			for (int c = 0; c < f.cols; c++)			//and each column's
+				for (int r = 0; r < f.rows; ) {
+					int n = 0;
+					while (r + n < f.rows && !shots.test((r + n) * f.cols + c))
+						n++;
+					addRunDensity(density, r * f.cols + c, f.cols, n, f.length[k]);
+					r += n + 1;
+				}
+		}
+		int best = 0, countUp = 0;
+		for (int cell = 0; cell < f.cells; cell++)
+			if (density[cell] > countUp) {
+				countUp = density[cell];
+				best = cell;
+			}
+		return best;
+	}
+
+	int last;
+	int t = targets.find(target, last);
+	if (t >= 0) {				//closes in on the target as GoodPlayer does
+		int hits[CompactTargets::MAXHITS];
+		int n = targets.hitsOf(t, hits);
+		int r1 = targets.row(f, hits[0]), c1 = targets.col(f, hits[0]);
+		if (n >= 2) {
+			int r2 = targets.row(f, hits[1]), c2 = targets.col(f, hits[1]);
+			if (r1 == r2) {			//along the row, from the last hit and then the first
+				int cl = 0;
+				for (int i = 0; i < n; i++)
+					if (targets.row(f, hits[i]) >= 0 && targets.col(f, hits[i]) >= 0)
+						cl = targets.col(f, hits[i]);
+				const int tries[4] = { cl + 1, cl - 1, c1 + 1, c1 - 1 };
+				for (int i = 0; i < 4; i++)
+					if (isOpen(f, shots, r1, tries[i]))
+						return r1 * f.cols + tries[i];
+			}
+			if (c1 == c2) {			//the same along the column
+				int rl = 0;
+				for (int i = 0; i < n; i++)
+					if (targets.row(f, hits[i]) >= 0 && targets.col(f, hits[i]) >= 0)
+						rl = targets.row(f, hits[i]);
+				const int tries[4] = { rl + 1, rl - 1, r1 - 1, r1 + 1 };
+				for (int i = 0; i < 4; i++)
+					if (isOpen(f, shots, tries[i], c1))
+						return tries[i] * f.cols + c1;
+			}
+			int targetId = targets.id[t];
+			int split = targets.add(targetId + 1);		//the hits after the first are another ship's
+			if (split >= 0) {
+				n = targets.hitsOf(targets.find(targetId, last), hits);		//adding can compact the targets
+				for (int i = 1; i < n; i++)
+					targets.hit[hits[i]] = uint16_t((targets.hit[hits[i]] & ~(15 << CompactTargets::OWNERSHIFT)) |
+						split << CompactTargets::OWNERSHIFT);
+			}
+		}
+		const int dr[4] = { -1, 0, 1, 0 }, dc[4] = { 0, -1, 0, 1 };		//around the first hit
+		for (int i = 0; i < 4; i++)
+			if (isOpen(f, shots, r1 + dr[i], c1 + dc[i]))
+				return (r1 + dr[i]) * f.cols + c1 + dc[i];
+	}
+	// Fires at random, as GoodPlayer does when nothing is open around its
+	// target.  GoodPlayer fires at (0, 0) if it has no target with the ID,
+	// which only overflowing the targets can bring about here; a random
+	// cell keeps the game going.
+	int left = f.cells - shots.count();
+	if (left == 0)
+		return 0;
+	return openCells(f, shots).nth(rng.nextInt(left));
+}
+
+// GoodPlayer::recordAttackResult for a hit, on the packed state
+void CompactPlayer::goodRecord(const CompactFleet& f, int cell, bool shipDestroyed, int shipId)
+{
+	state = 2;
+	int last;
+	if (targets.find(target, last) < 0) {		//a new target, with the next ID after the oldest's
+		target = int8_t(last + 1);
+		if (targets.add(target) >= 0)
+			targets.addHit(target, cell);
+		return;
+	}
+	targets.addHit(target, cell);
+	int t = targets.find(target, last);		//adding a hit can compact the targets
+	if (!shipDestroyed)
+		return;
+
+	targets.destroyed |= uint16_t(1 << t);
+	target = -1;
+	state = 1;
+	int length = f.length[shipId];
+	int counted = f.nShips - 1;			//the ship of that length with the highest ID
+	while (f.length[counted] != length)
+		counted--;
+	gone |= uint8_t(1 << counted);		//leaves the densities once, however many of that length sink
+
+	int hits[CompactTargets::MAXHITS];
+	int n = targets.hitsOf(t, hits);
+	if (n > length) {			//the hits were of more than one ship: strikes out the sunk one's from the last hit back
+		int first = hits[0], end = hits[n - 1];
+		bool vertical = targets.col(f, first) == targets.col(f, end);
+		int step = vertical ? (targets.row(f, first) < targets.row(f, end) ? -1 : 1)
+			: (targets.col(f, first) < targets.col(f, end) ? -1 : 1);
+		for (int i = 0; i < length; i++) {
+			int want = (vertical ? targets.row(f, end) : targets.col(f, end)) + step;
+			for (int j = 0; j < n; j++) {
+				int h = hits[j];
+				if ((vertical ? targets.row(f, h) : targets.col(f, h)) == want) {
+					targets.hit[end] |= (vertical ? CompactTargets::ROWGONE : CompactTargets::COLGONE);
+					end = h;
+					break;
+				}
+			}
+		}
+		int rest[CompactTargets::MAXHITS];		//the hits not struck out are a new target's
+		int nRest = 0;
+		for (int j = 0; j < n; j++)
+			if (targets.row(f, hits[j]) != -10 && targets.col(f, hits[j]) != -10)
+				rest[nRest++] = targets.cell(hits[j]);
+		target = int8_t(targets.id[t] + 1);
+		if (targets.add(target) >= 0)
+			for (int j = 0; j < nRest; j++)
+				targets.addHit(target, rest[j]);
+		state = 2;
+		return;
+	}
+
+	for (int u = targets.nTargets - 1; u >= 0; u--)		//takes up the newest target not destroyed
+		if (!((targets.destroyed >> u) & 1)) {
+			target = targets.id[u];
+			state = 2;
+			break;
+		}
+}
+
+int mediocreAttack(const CompactFleet& f, Rng& rng, uint8_t& state, int lastCell, const CellMask& shots)
+{
+	if (state == 2) {				//picks an unattacked cell within 4 of the hit, along its row or column
+		int r = lastCell / f.cols, c = lastCell % f.cols;
+		int lo[2] = { max(0, r - 4), max(0, c - 4) };
+		int hi[2] = { min(f.rows - 1, r + 4), min(f.cols - 1, c + 4) };
+		int first = rng.nextInt(2) == 1 ? 0 : 1;		//0 is the column, 1 the row
+		for (int pass = 0; pass < 2; pass++) {
+			int along = (pass == 0 ? first : 1 - first);
+			int count = 0;
+			for (int i = lo[along]; i <= hi[along]; i++)
+				count += !shots.test(along == 0 ? i * f.cols + c : r * f.cols + i);
+			if (count == 0)
+				continue;
+			int pick = rng.nextInt(count);
+			for (int i = lo[along]; ; i++) {
+				int cell = (along == 0 ? i * f.cols + c : r * f.cols + i);
+				if (!shots.test(cell) && pick-- == 0)
+					return cell;
+			}
+		}
+		state = 1;
+	}
+
+	int left = f.cells - shots.count();
+	if (left == 0)
+		return 0;
+	return openCells(f, shots).nth(rng.nextInt(left));
+}
+
+void mediocreRecord(uint8_t& state, uint8_t& lastCell, int cell, bool validShot, bool shotHit, bool shipDestroyed)
+{
+	if (!validShot || !shotHit)
+		return;
+	if (shipDestroyed) {
+		state = 1;
+		lastCell = CompactPlayer::NOCELL;
+	}
+	else if (state == 1) {
+		state = 2;
+		lastCell = uint8_t(cell);
+	}
+}
+
+bool CompactGame::start(const CompactFleet& f, CompactPlayer::Kind k0, CompactPlayer::Kind k1, uint64_t seed,
+	CompactPlacer& scratch)
+{
+	Rng rng(seed);					//the players draw their seeds in order, as from a Game
+	player[0].reset(k0, rng.next());
+	player[1].reset(k1, rng.next());
+	toMove = 0;
+	winner = -1;
+	return player[0].placeShips(f, board[0], scratch) && player[1].placeShips(f, board[1], scratch);
+}
+
+bool CompactGame::playTurn(const CompactFleet& f)
+{
+	CompactPlayer& attacker = player[toMove];
+	CompactBoard& target = board[1 - toMove];
+	int cell = attacker.recommendAttack(f, target);
+	bool hit, destroyed;
+	int id = -1;
+	bool valid = target.attack(f, cell, hit, destroyed, id);
+	attacker.recordAttackResult(f, cell, valid, hit, destroyed, id);
+	if (target.allShipsDestroyed()) {
+		winner = int8_t(toMove);
+		return true;
+	}
+	toMove = uint8_t(1 - toMove);
+	return false;
+}
+
+int CompactGame::play(const CompactFleet& f)
+{
+	while (!playTurn(f))
+		;
+	return winner;
+}
@@ -0,0 +1,167 @@
+#ifndef COMPACTGAME_INCLUDED
+#define COMPACTGAME_INCLUDED
+
+#include "Random.h"
+#include "Bitboard.h"
+#include "FleetPlacer.h"
+#include <cstdint>
+#include <vector>
+
+class Game;
+
+// A whole two-player game packed into a few cache lines, for keeping huge
+// numbers of games in memory at once.  It covers boards of up to 128 cells
+// (10x10 among them) with up to 8 ships, and the awful, mediocre and good
+// computer strategies.  A player's memory is a generator and a few bytes:
+// the cells it has not attacked are just those not shot on the other
+// board, and the good player's placement densities are worked out from
+// them when it needs them, so it keeps only its targets.  The board and
+// fleet, the same for every game of a batch, are kept once in a
+// CompactFleet instead of in each game, and the scratch space for placing
+// fleets once per thread in a CompactPlacer.
+
+// A set of cells of a board of up to 128 cells; cell = r * cols + c is bit
+// cell % 64 of word cell / 64
+struct CellMask
+{
+	uint64_t w[2];
+
+	void clear() { w[0] = w[1] = 0; }
+	bool test(int cell) const { return (w[cell >> 6] >> (cell & 63)) & 1; }
+	void set(int cell) { w[cell >> 6] |= uint64_t(1) << (cell & 63); }
+	int count() const;
+	// Returns the cell of the nth member, counting from 0 in cell order
+	int nth(int n) const;
+};
+
+struct CompactFleet
+{
+	enum { MAXCELLS = 128, MAXSHIPS = 8 };
+	// Copies the game's board size and fleet, or returns false if they are
+	// too big to pack
+	bool set(const Game& g);
+	int rows, cols, cells, nShips;
+	uint8_t length[MAXSHIPS];
+};
+
+// Scratch space for placing fleets, reused from game to game.  A thread
+// starting games needs one of its own.
+struct CompactPlacer
+{
+	FleetPlacer placer;
+	Bitboard taken;						//the cells a mediocre player blocked
+	std::vector<int> lengths;
+	std::vector<ShipPlacement> layout;
+};
+
+// One player's ships and the shots fired at them
+struct CompactBoard
+{
+	CellMask ships, shots;
+	uint8_t start[CompactFleet::MAXSHIPS];		//each ship's top or left cell
+	uint8_t health[CompactFleet::MAXSHIPS];		//each ship's cells not yet hit
+	uint8_t vertical;							//bit k is set if ship k is vertical
+	uint8_t cellsLeft;							//ship cells not yet hit
+
+	void clear();
+	bool placeShip(const CompactFleet& f, int shipId, int cell, bool isVertical);
+	// The same rules as Board::attack: a shot off the board or at a cell
+	// already shot is invalid.  shipId is set only if a ship was destroyed.
+	bool attack(const CompactFleet& f, int cell, bool& shotHit, bool& shipDestroyed, int& shipId);
+	bool allShipsDestroyed() const { return cellsLeft == 0; }
+};
+
+// The good strategy's targets, kept as GoodPlayer keeps them: a list,
+// oldest first, of target IDs, each with the hits it is closing in on in
+// the order they were added.  The hits of all the targets share one array,
+// each tagged with its target.  GoodPlayer sometimes strikes out a hit's
+// row or column, which then reads as -10.  A target shadowed by a newer
+// one with the same ID is never looked up again, so when the arrays fill
+// up the hits of such targets are dropped, and the targets too unless
+// GoodPlayer could still take one up or it is the oldest, whose ID the
+// next new target's follows.  No game of 20000 on 10x10 with the standard
+// fleet fills the arrays, and in 5000 games each on boards from 7x9 to
+// 11x11 with 7 or 8 ships none needed more than 8 targets and 23 hits
+// after dropping them.
+struct CompactTargets
+{
+	enum { MAXTARGETS = 16, MAXHITS = 48 };
+	// A hit is its cell, its target and whether its row and column were
+	// struck out
+	enum { OWNERSHIFT = 7, ROWGONE = 1 << 11, COLGONE = 1 << 12 };
+	uint8_t nTargets, nHits;
+	int8_t id[MAXTARGETS];
+	uint16_t destroyed;				//bit t is set if target t is destroyed
+	uint16_t hit[MAXHITS];
+
+	void clear() { nTargets = nHits = 0; destroyed = 0; }
+	// The newest target with the ID, or -1; last is set to the ID of the
+	// oldest target, or -1 if there are none, if there is no such target
+	int find(int targetId, int& last) const;
+	// Adds a target, or returns -1 if there is no room
+	int add(int targetId);
+	// Sets out to the target's hits, in order, and returns how many
+	int hitsOf(int target, int* out) const;
+	// Adds a hit to the newest target with the ID unless there is no room
+	void addHit(int targetId, int c);
+	// Drops what can never be looked up again
+	void compact();
+	int cell(int i) const { return hit[i] & 127; }
+	int owner(int i) const { return (hit[i] >> OWNERSHIFT) & 15; }
+	int row(const CompactFleet& f, int i) const { return hit[i] & ROWGONE ? -10 : cell(i) / f.cols; }
+	int col(const CompactFleet& f, int i) const { return hit[i] & COLGONE ? -10 : cell(i) % f.cols; }
+};
+
+struct CompactPlayer
+{
+	enum Kind { AWFUL, MEDIOCRE, GOOD };
+	Rng rng;
+	uint8_t kind;
+	uint8_t state;			//mediocre: 1 searching, 2 closing in on lastCell; good: 1 hunting, 2 targeting
+	uint8_t lastCell;		//awful: the cell last attacked; mediocre: the hit to close in on, or NOCELL
+	enum { NOCELL = 255 };
+	int8_t target;			//good: the ID of the target it is closing in on, or -1
+	uint8_t gone;			//good: bit k is set if ship k's placements are out of its densities
+	CompactTargets targets;	//good only
+
+	void reset(Kind k, uint64_t seed);
+	// Places the fleet as the full player of the kind does: awful in its
+	// fixed rows, mediocre with half the cells blocked at random and a
+	// layout searched for on the rest, and good uniformly at random
+	bool placeShips(const CompactFleet& f, CompactBoard& b, CompactPlacer& scratch);
+	// target is the other player's board, whose shots are this player's
+	int recommendAttack(const CompactFleet& f, const CompactBoard& target);
+	void recordAttackResult(const CompactFleet& f, int cell, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+
+private:
+	int goodAttack(const CompactFleet& f, const CellMask& shots);
+	void goodRecord(const CompactFleet& f, int cell, bool shipDestroyed, int shipId);
+};
+
+// The mediocre strategy's next shot, given the shots already fired at the
+// target board: a cell within 4 of lastCell along its row or column while
+// state is 2, or else any unattacked cell.  Sets state to 1 when nothing
+// is left near lastCell.  Returns 0 if every cell has been attacked.
+int mediocreAttack(const CompactFleet& f, Rng& rng, uint8_t& state, int lastCell, const CellMask& shots);
+// Updates the mediocre strategy's state and lastCell after a shot
+void mediocreRecord(uint8_t& state, uint8_t& lastCell, int cell, bool validShot, bool shotHit, bool shipDestroyed);
+
+struct CompactGame
+{
+	CompactBoard board[2];		//board[i] holds player i's ships
+	CompactPlayer player[2];
+	uint8_t toMove;				//the player whose turn it is
+	int8_t winner;				//-1 until the game is over, and if a fleet could not be placed
+
+	// Starts a game between players of the given kinds, seeding them from
+	// seed and having them place their ships.  Returns false if either
+	// could not.  Player 0 moves first.
+	bool start(const CompactFleet& f, CompactPlayer::Kind k0, CompactPlayer::Kind k1, uint64_t seed,
+		CompactPlacer& scratch);
+	// Plays one turn, and returns true if it ended the game
+	bool playTurn(const CompactFleet& f);
+	// Plays a started game to the end and returns the winner
+	int play(const CompactFleet& f);
+};
+
+#endif // COMPACTGAME_INCLUDED
@@ -0,0 +1,98 @@
+#include "Density.h"
+
+using namespace std;
+
+namespace
+{
+	// min and max by arithmetic, since a compiler that turns them into
+	// branches mispredicts them constantly on a scattered board
+	inline int lesser(int a, int b)
+	{
+		int d = b - a;
+		return a + (d & (d >> 31));
+	}
+
+	inline int positivePart(int a)
+	{
+		return a & ~(a >> 31);
+	}
+}
+
+void PlacementDensity::setCells(const Grid<char>& cells, char freeMark)
+{
+	int rows = cells.rows();
+	int cols = cells.cols();
+	if (m_rowEnd.rows() != rows || m_rowEnd.cols() != cols) {
+		m_rowEnd.resize(rows, cols);
+		m_rowLen.resize(rows, cols);
+		m_colEnd.resize(rows, cols);
+		m_colLen.resize(rows, cols);
+		m_below.resize(cols);
+		m_fits.resize((rows > cols ? rows : cols) + 1);
+	}
+
+	// Counting free cells with (count + 1) & -free restarts the count at every
+	// taken cell without branching.  A cell's count from its run's start is
+	// i + 1, its count from the run's end is n - i, and the run's length is
+	// their sum less one.  The pass from the start keeps its count in the
+	// end grid until the pass from the end replaces it.
+	for (int r = 0; r < rows; r++) {
+		const char* in = &cells(r, 0);
+		int* end = &m_rowEnd(r, 0);
+		int* len = &m_rowLen(r, 0);
+		int fromStart = 0;
+		for (int c = 0; c < cols; c++) {
+			fromStart = (fromStart + 1) & -int(in[c] == freeMark);
+			end[c] = fromStart;
+		}
+		int fromEnd = 0;
+		for (int c = cols - 1; c >= 0; c--) {
+			fromEnd = (fromEnd + 1) & -int(in[c] == freeMark);
+			len[c] = positivePart(end[c] + fromEnd - 1);
+			end[c] = lesser(end[c], fromEnd);
+		}
+	}
+
+	for (int r = 0; r < rows; r++) {				//the same for columns, a row at a time
+		const char* in = &cells(r, 0);
+		const int* above = (r == 0 ? nullptr : &m_colEnd(r - 1, 0));
+		int* end = &m_colEnd(r, 0);
+		for (int c = 0; c < cols; c++)
+			end[c] = ((above == nullptr ? 0 : above[c]) + 1) & -int(in[c] == freeMark);
+	}
+	int* below = m_below.data();
+	for (int c = 0; c < cols; c++)
+		below[c] = 0;
+	for (int r = rows - 1; r >= 0; r--) {
+		const char* in = &cells(r, 0);
+		int* end = &m_colEnd(r, 0);
+		int* len = &m_colLen(r, 0);
+		for (int c = 0; c < cols; c++) {
+			below[c] = (below[c] + 1) & -int(in[c] == freeMark);
+			len[c] = positivePart(end[c] + below[c] - 1);
+			end[c] = lesser(end[c], below[c]);
+		}
+	}
+}
+
+void PlacementDensity::add(int length, int weight, Grid<int>& density)
+{
+	for (size_t n = 0; n < m_fits.size(); n++)
+		m_fits[n] = positivePart(lesser(length, int(n) - length + 1));
+	int cells = m_rowEnd.rows() * m_rowEnd.cols();
+	const int* rowEnd = m_rowEnd.data();
+	const int* rowLen = m_rowLen.data();
+	const int* colEnd = m_colEnd.data();
+	const int* colLen = m_colLen.data();
+	const int* fits = m_fits.data();
+	int* out = density.data();
+	for (int i = 0; i < cells; i++)
+		out[i] += weight * (lesser(rowEnd[i], fits[rowLen[i]]) + lesser(colEnd[i], fits[colLen[i]]));
+}
+
+void addPlacementDensity(const Grid<char>& cells, char freeMark, int length, int weight, Grid<int>& density)
+{
+	PlacementDensity kernel;
+	kernel.setCells(cells, freeMark);
+	kernel.add(length, weight, density);
+}
@@ -0,0 +1,37 @@
+#ifndef DENSITY_INCLUDED
+#define DENSITY_INCLUDED
+
+#include "Grid.h"
+
+// Counts, for every cell, how many placements of a ship could cover it.
+// setCells records the runs of free cells in every row and column once;
+// add then works out each cell's count in closed form from its offset i
+// in its run of n free cells: min(i + 1, n - i, length, n - length + 1).
+// The first two terms depend only on the cells and are kept by setCells,
+// and the last two only on n and the length, so add looks them up in a
+// table of run lengths; a cell then costs two loads and a minimum each way.
+// Call setCells once per grid and add once per ship length.  Horizontal
+// and vertical placements are counted separately, so a one-cell ship
+// counts twice.
+class PlacementDensity
+{
+public:
+	// Treats the cells equal to freeMark as free and all others as taken
+	void setCells(const Grid<char>& cells, char freeMark);
+	// Adds weight times the number of placements of a ship of the given
+	// length lying entirely on free cells that cover each cell to density
+	void add(int length, int weight, Grid<int>& density);
+
+private:
+	// The distance of each cell from the nearer end of its horizontal and
+	// vertical free runs, counting itself, and the lengths of those runs; a
+	// taken cell has 0 for both
+	Grid<int> m_rowEnd, m_rowLen, m_colEnd, m_colLen;
+	std::vector<int> m_below;		//free cells below the current row in each column's run
+	std::vector<int> m_fits;		//per run length: min(length, n - length + 1), or 0 if the ship does not fit
+};
+
+// Convenience for a single length: the same as setCells followed by add
+void addPlacementDensity(const Grid<char>& cells, char freeMark, int length, int weight, Grid<int>& density);
+
+#endif // DENSITY_INCLUDED
@@ -0,0 +1,361 @@
+#include "FleetPlacer.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+void FleetPlacer::setBoard(int rows, int cols)
+{
+	m_free.resize(rows, cols);
+	m_free.fill();
+}
+
+void FleetPlacer::setTaken(const Bitboard& taken)
+{
+	m_free.andNot(taken);
+}
+
+long long FleetPlacer::candidates(int length)
+{
+	m_free.runStarts(length, HORIZONTAL, m_starts[0]);
+	m_free.runStarts(length, VERTICAL, m_starts[1]);
+	return m_starts[0].count() + m_starts[1].count();
+}
+
+ShipPlacement FleetPlacer::candidate(long long n) const
+{
+	ShipPlacement p;
+	long long horizontal = m_starts[0].count();
+	p.dir = (n < horizontal ? HORIZONTAL : VERTICAL);
+	if (n >= horizontal)
+		n -= horizontal;
+	m_starts[p.dir == HORIZONTAL ? 0 : 1].nth(n, p.topOrLeft.r, p.topOrLeft.c);
+	return p;
+}
+
+void FleetPlacer::occupy(const ShipPlacement& p, int length, bool on)
+{
+	if (on)
+		m_free.resetRun(p.topOrLeft.r, p.topOrLeft.c, length, p.dir);
+	else m_free.setRun(p.topOrLeft.r, p.topOrLeft.c, length, p.dir);
+}
+
+FleetPlacer::Result FleetPlacer::place(const vector<int>& lengths, Rng& rng, vector<ShipPlacement>& out,
+	long long maxSteps)
+{
+	int n = int(lengths.size());
+	out.resize(n);
+	m_stack.resize(n);
+	long long steps = 0;
+	int k = 0;
+	bool descending = true;			// true when ship k has just been reached from ship k-1
+
+	while (k >= 0 && k < n) {
+		Frame& f = m_stack[k];
+		if (descending) {			// a new ship starts from a random candidate
+			f.count = candidates(lengths[k]);
+			f.first = (f.count > 0 ? rng.nextInt(int(f.count)) : 0);
+			f.tried = 0;
+		}
+		else {						// the ships after k could not fit, so move ship k on
+			occupy(out[k], lengths[k], false);
+			candidates(lengths[k]);
+			f.tried++;
+		}
+		if (f.tried >= f.count) {	// ship k has no room left; back up to the previous ship
+			k--;
+			descending = false;
+			continue;
+		}
+		if (++steps > maxSteps) {
+			for (int i = 0; i <= k - 1; i++)
+				occupy(out[i], lengths[i], false);
+			return GAVE_UP;
+		}
+		out[k] = candidate((f.first + f.tried) % f.count);
+		occupy(out[k], lengths[k], true);
+		k++;
+		descending = true;
+	}
+
+	if (k < 0)						// every ship was unplaced on the way back
+		return INFEASIBLE;
+	for (int i = 0; i < n; i++)		// leaves the board free for the next layout
+		occupy(out[i], lengths[i], false);
+	return PLACED;
+}
+
+FleetPlacer::Result FleetPlacer::placeUniform(const vector<int>& lengths, Rng& rng, vector<ShipPlacement>& out, int maxTries)
+{
+	int n = int(lengths.size());
+	out.resize(n);
+	m_stack.resize(n);			//ready for place(), which callers fall back on when the draws give up
+	m_drawn.resize(m_free.rows(), m_free.cols());
+	for (int tries = 0; tries < maxTries; tries++) {
+		m_drawn.clear();
+		int k = 0;
+		for (; k < n; k++) {
+			long long count = candidates(lengths[k]);	// m_free never holds the drawn ships
+			if (count == 0)
+				return INFEASIBLE;
+			out[k] = candidate(rng.nextInt(int(count)));
+			const ShipPlacement& p = out[k];
+			if (m_drawn.anyInRun(p.topOrLeft.r, p.topOrLeft.c, lengths[k], p.dir))
+				break;					// an overlap rejects the whole layout
+			m_drawn.setRun(p.topOrLeft.r, p.topOrLeft.c, lengths[k], p.dir);
+		}
+		if (k == n)
+			return PLACED;
+	}
+	return GAVE_UP;
+}
+
+namespace
+{
+	const size_t MAXFAILED = 1 << 12;			//slots in the failed-state table, 48 KB; it is kept at most half full
+	const long long MEMOSTEPS = 1000;			//steps a search takes before it remembers failed states
+	const size_t MAXFITANSWERS = 4096;			//answers checkFleetFits remembers before starting over
+	const long long FITSTEPS = 200000;			//steps checkFleetFits searches before it gives up
+
+	// Folds w into the hash h so that the order of the words matters
+	inline uint64_t mixKey(uint64_t h, uint64_t w)
+	{
+		h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+		return h ^ (h >> 29);
+	}
+
+	mutex fitMutex;
+	unordered_map<string, FleetPlacer::Result> fitAnswers;		//keyed by fitKey
+
+	// The board size, the lengths from longest to shortest and the taken cells
+	string fitKey(int rows, int cols, const vector<int>& sorted, const Bitboard* taken)
+	{
+		string key;
+		key.append(reinterpret_cast<const char*>(&rows), sizeof(int));
+		key.append(reinterpret_cast<const char*>(&cols), sizeof(int));
+		size_t n = sorted.size();
+		key.append(reinterpret_cast<const char*>(&n), sizeof(n));
+		for (size_t k = 0; k < sorted.size(); k++)
+			key.append(reinterpret_cast<const char*>(&sorted[k]), sizeof(int));
+		if (taken != nullptr)
+			for (int r = 0; r < rows; r++)
+				key.append(reinterpret_cast<const char*>(taken->row(r)), taken->wordsPerRow() * sizeof(uint64_t));
+		return key;
+	}
+}
+
+void FleetPlacer::runStarts(int length, Bitboard& horizontal, Bitboard& vertical) const
+{
+	m_free.runStarts(length, HORIZONTAL, horizontal);
+	if (length > 1)
+		m_free.runStarts(length, VERTICAL, vertical);
+	else vertical.resize(m_free.rows(), m_free.cols());		//a one-cell ship lies the same both ways
+}
+
+// Hashes the ships left of each length and the free cells
+uint64_t FleetPlacer::stateKey() const
+{
+	uint64_t h = 0x243F6A8885A308D3ULL;
+	for (size_t g = 0; g < m_nGroups; g++)
+		h = mixKey(h, uint64_t(m_groups[g].left));
+	for (int r = 0; r < m_free.rows(); r++)
+		for (int w = 0; w < m_free.wordsPerRow(); w++)
+			h = mixKey(h, m_free.row(r)[w]);
+	return h;
+}
+
+bool FleetPlacer::hasFailed(uint64_t key) const
+{
+	size_t mask = m_failed.size() - 1;
+	for (size_t i = size_t(key) & mask; m_failedIn[i] == m_generation; i = (i + 1) & mask)
+		if (m_failed[i] == key)
+			return true;
+	return false;
+}
+
+void FleetPlacer::addFailed(uint64_t key)
+{
+	if (2 * (m_nFailed + 1) > m_failed.size())		//keeps the table at most half full
+		return;
+	size_t mask = m_failed.size() - 1;
+	size_t i = size_t(key) & mask;
+	while (m_failedIn[i] == m_generation && m_failed[i] != key)
+		i = (i + 1) & mask;
+	if (m_failedIn[i] != m_generation) {
+		m_failed[i] = key;
+		m_failedIn[i] = m_generation;
+		m_nFailed++;
+	}
+}
+
+FleetPlacer::Result FleetPlacer::solve(const vector<int>& lengths, vector<ShipPlacement>& out, long long maxSteps)
+{
+	int n = int(lengths.size());
+	out.resize(n);
+	m_nGroups = 0;
+	int total = 0;
+	for (int k = 0; k < n; k++) {			//ships of the same length are interchangeable
+		size_t g = 0;
+		while (g < m_nGroups && m_groups[g].length != lengths[k])
+			g++;
+		if (g == m_nGroups) {
+			if (m_nGroups == m_groups.size())
+				m_groups.push_back(Group());
+			m_groups[g].length = lengths[k];
+			m_groups[g].ships.clear();
+			m_groups[g].left = 0;
+			m_nGroups++;
+		}
+		m_groups[g].ships.push_back(k);
+		m_groups[g].left++;
+		total += lengths[k];
+	}
+	if (m_levelStarts.size() < size_t(3 * n)) {
+		m_levelStarts.resize(3 * n);
+		for (int i = 0; i < 3 * n; i++)		//sized now, so the swaps in solveRec never hand runStarts an empty set to fill
+			m_levelStarts[i].resize(m_free.rows(), m_free.cols());
+	}
+	if (m_keys.size() < size_t(n))
+		m_keys.resize(n);
+	if (m_failed.size() != MAXFAILED) {		//made by the first search, so later ones allocate nothing
+		m_failed.assign(MAXFAILED, 0);
+		m_failedIn.assign(MAXFAILED, 0);
+		m_generation = 0;
+	}
+	if (++m_generation == 0) {				//empties the failed-state table without touching it, except once in 2^32 searches
+		m_failedIn.assign(m_failedIn.size(), 0);
+		m_generation = 1;
+	}
+	m_nFailed = 0;
+	m_steps = 0;
+	m_maxSteps = maxSteps;
+	m_out = &out;
+
+	bool found = solveRec(0, total);
+	if (!found)
+		return m_steps > m_maxSteps ? GAVE_UP : INFEASIBLE;
+	for (int k = 0; k < n; k++)		//leaves the board free for the next layout
+		occupy(out[k], lengths[k], false);
+	return PLACED;
+}
+
+bool FleetPlacer::solveRec(int depth, int lengthLeft)
+{
+	if (lengthLeft == 0)
+		return true;
+	if (++m_steps > m_maxSteps || m_free.count() < lengthLeft)
+		return false;
+	bool memo = (m_steps > MEMOSTEPS);		//a short search would spend more on the keys than it saves
+	uint64_t& key = m_keys[depth];
+	if (memo) {
+		key = stateKey();
+		if (hasFailed(key))
+			return false;
+	}
+
+	Bitboard& horizontal = m_levelStarts[3 * depth];
+	Bitboard& vertical = m_levelStarts[3 * depth + 1];
+	Bitboard& columns = m_levelStarts[3 * depth + 2];
+	int best = -1;
+	long long bestCount = 0;
+	for (size_t g = 0; g < m_nGroups; g++) {		//picks the ships with the fewest positions
+		if (m_groups[g].left == 0)
+			continue;
+		runStarts(m_groups[g].length, m_starts[0], m_starts[1]);
+		long long count = m_starts[0].count() + m_starts[1].count();
+		if (count < m_groups[g].left) {		//too few positions even if none overlapped
+			best = -1;
+			break;
+		}
+		if (best < 0 || count < bestCount) {
+			best = int(g);
+			bestCount = count;
+			swap(horizontal, m_starts[0]);
+			swap(vertical, m_starts[1]);
+		}
+	}
+
+	if (best >= 0) {
+		Group& g = m_groups[best];
+		columns.resize(1, m_free.cols());			//the columns holding a candidate, so empty ones are skipped
+		for (int r = 0; r < m_free.rows(); r++)
+			for (int w = 0; w < m_free.wordsPerRow(); w++)
+				columns.row(0)[w] |= horizontal.row(r)[w] | vertical.row(r)[w];
+		for (int w = 0; w < columns.wordsPerRow(); w++)
+			for (uint64_t bits = columns.row(0)[w]; bits != 0; bits &= bits - 1) {
+				int c = 64 * w + Bitboard::lowestBit(bits);
+				for (int r = 0; r < m_free.rows(); r++) {
+					ShipPlacement p;
+					p.topOrLeft = Point(r, c);
+					p.dir = HORIZONTAL;
+					if (horizontal.test(r, c) && tryPlacement(p, g, depth, lengthLeft))
+						return true;
+					p.dir = VERTICAL;
+					if (vertical.test(r, c) && tryPlacement(p, g, depth, lengthLeft))
+						return true;
+					if (m_steps > m_maxSteps)
+						return false;
+				}
+			}
+	}
+
+	if (memo)
+		addFailed(key);
+	return false;
+}
+
+bool FleetPlacer::tryPlacement(const ShipPlacement& p, Group& g, int depth, int lengthLeft)
+{
+	int id = g.ships[g.ships.size() - g.left];
+	(*m_out)[id] = p;
+	occupy(p, g.length, true);
+	g.left--;
+	if (solveRec(depth + 1, lengthLeft - g.length))
+		return true;
+	g.left++;
+	occupy(p, g.length, false);
+	return false;
+}
+
+FleetPlacer::Result checkFleetFits(int rows, int cols, const vector<int>& lengths, const Bitboard* taken)
+{
+	long long area = 0;
+	for (size_t k = 0; k < lengths.size(); k++)
+		area += lengths[k];
+	if (area > (long long)rows * cols - (taken != nullptr ? taken->count() : 0))
+		return FleetPlacer::INFEASIBLE;
+
+	vector<int> sorted(lengths);
+	sort(sorted.begin(), sorted.end(), greater<int>());
+	string key = fitKey(rows, cols, sorted, taken);
+	{
+		lock_guard<mutex> lock(fitMutex);
+		unordered_map<string, FleetPlacer::Result>::const_iterator it = fitAnswers.find(key);
+		if (it != fitAnswers.end())
+			return it->second;
+	}
+
+	FleetPlacer placer;			//searched without the lock, so threads asking about other fleets do not wait
+	placer.setBoard(rows, cols);
+	if (taken != nullptr)
+		placer.setTaken(*taken);
+	vector<ShipPlacement> layout;
+	FleetPlacer::Result fits = placer.solve(sorted, layout, FITSTEPS);
+	if (fits == FleetPlacer::GAVE_UP)		//a longer search could still settle it
+		return fits;
+
+	lock_guard<mutex> lock(fitMutex);
+	if (fitAnswers.size() >= MAXFITANSWERS)
+		fitAnswers.clear();
+	fitAnswers[key] = fits;
+	return fits;
+}
+
+bool fleetFits(int rows, int cols, const vector<int>& lengths, const Bitboard* taken)
+{
+	return checkFleetFits(rows, cols, lengths, taken) == FleetPlacer::PLACED;
+}
@@ -0,0 +1,115 @@
+#ifndef FLEETPLACER_INCLUDED
+#define FLEETPLACER_INCLUDED
+
+#include "Bitboard.h"
+#include "globals.h"
+#include <cstdint>
+#include <vector>
+
+struct ShipPlacement
+{
+	Point topOrLeft;
+	Direction dir;
+};
+
+// Finds layouts of a fleet on a board.  The candidate positions of a
+// ship are found as whole bit masks: the free cells where a run of the
+// ship's length starts, horizontally and vertically.  A layout never takes
+// deeper recursion than an explicit stack of one frame per ship.
+class FleetPlacer
+{
+public:
+	enum Result {
+		PLACED,			// the layout is in the output vector
+		INFEASIBLE,		// no layout of the fleet fits on the board
+		GAVE_UP			// the search ran out of its step budget
+	};
+
+	FleetPlacer() : m_nGroups(0), m_nFailed(0), m_generation(0), m_steps(0), m_maxSteps(0), m_out(nullptr) {}
+
+	// Makes every cell of a rows x cols board free
+	void setBoard(int rows, int cols);
+	// Makes the cells in taken unavailable to ships
+	void setTaken(const Bitboard& taken);
+
+	// Places the ships, in order, each at a uniformly random position among
+	// those still free.  A ship with no room sends the search back to try
+	// the earlier ships elsewhere, so the search is complete: it reports
+	// INFEASIBLE only when no layout exists, and GAVE_UP only if it takes
+	// more than maxSteps placements.
+	Result place(const std::vector<int>& lengths, Rng& rng, std::vector<ShipPlacement>& out,
+		long long maxSteps = 1000000);
+
+	// Draws a layout uniformly from all the layouts of the fleet by drawing
+	// every ship independently from its positions on the board without the
+	// other ships, and starting the whole layout over on any overlap.
+	// Reports GAVE_UP after maxTries overlapping draws.
+	Result placeUniform(const std::vector<int>& lengths, Rng& rng, std::vector<ShipPlacement>& out,
+		int maxTries = 1000);
+
+	// Finds a layout without randomness.  The ship with the fewest candidate
+	// positions goes next, each ship tries its positions column by column,
+	// horizontal before vertical, and a state with too little room left is
+	// abandoned early.  States already shown to fail are remembered so that
+	// swapping ships of the same length is not searched twice, once a search
+	// runs long enough for that to pay.  A state is remembered by a 64-bit
+	// hash in a fixed open-addressed table of 2048 states (48 KB), made by the
+	// first search and kept between searches, so after its first search a
+	// placer allocates nothing.  A search that fills the table stops
+	// remembering.  Two states with the same hash would be taken for each
+	// other, which for 64-bit hashes of so few states is vanishingly
+	// unlikely.
+	Result solve(const std::vector<int>& lengths, std::vector<ShipPlacement>& out,
+		long long maxSteps = 1000000);
+
+private:
+	Bitboard m_free;				// cells not taken and not holding a ship
+	Bitboard m_starts[2];			// scratch: candidate positions, by direction
+	Bitboard m_drawn;				// scratch: cells of the ships placeUniform has drawn
+	struct Frame {
+		long long first;			// candidate the ship started from
+		long long tried;			// candidates tried so far
+		long long count;			// candidates available to the ship
+	};
+	std::vector<Frame> m_stack;
+
+	struct Group {					//ships of one length, for solve()
+		int length;
+		std::vector<int> ships;		//IDs of the ships, the placed ones first
+		int left;					//ships not yet placed
+	};
+	std::vector<Group> m_groups;	//the first m_nGroups are in use; the rest keep their storage
+	size_t m_nGroups;
+	std::vector<Bitboard> m_levelStarts;	//per depth: the placed ship's candidates each way and their columns
+	std::vector<uint64_t> m_keys;			//per depth: the state's hash
+	std::vector<uint64_t> m_failed;			//hashes of the states shown to fail, open-addressed
+	std::vector<uint32_t> m_failedIn;		//per slot: the search that filled it; others are empty
+	size_t m_nFailed;						//slots this search has filled
+	uint32_t m_generation;					//the current search
+	long long m_steps, m_maxSteps;
+	std::vector<ShipPlacement>* m_out;
+
+	long long candidates(int length);
+	ShipPlacement candidate(long long n) const;
+	void occupy(const ShipPlacement& p, int length, bool on);
+	void runStarts(int length, Bitboard& horizontal, Bitboard& vertical) const;
+	bool solveRec(int depth, int lengthLeft);
+	bool tryPlacement(const ShipPlacement& p, Group& g, int depth, int lengthLeft);
+	uint64_t stateKey() const;
+	bool hasFailed(uint64_t key) const;
+	void addFailed(uint64_t key);
+};
+
+// Searches for a layout of the ships on a rows x cols board that does not
+// use the cells in taken (if any).  Returns PLACED if one exists,
+// INFEASIBLE if none does, and GAVE_UP if a search of a bounded number of
+// placements settled neither, which only crowded fleets of many long ships
+// take.  Settled answers are remembered for the same board and the same
+// lengths in any order, so asking again is cheap; GAVE_UP is not, since it
+// is no answer.  Safe to call from several threads.
+FleetPlacer::Result checkFleetFits(int rows, int cols, const std::vector<int>& lengths,
+	const Bitboard* taken = nullptr);
+// Returns true only if checkFleetFits finds a layout of the ships
+bool fleetFits(int rows, int cols, const std::vector<int>& lengths, const Bitboard* taken = nullptr);
+
+#endif // FLEETPLACER_INCLUDED
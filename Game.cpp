@@ -1,11 +1,17 @@
 #include "Game.h"
 #include "Board.h"
 #include "Player.h"
+#include "GameObserver.h"
+#include "PlayLoop.h"
+#include "FleetPlacer.h"
 #include "globals.h"
 #include <iostream>
 #include <string>
 #include <cstdlib>
 #include <cctype>
+#include <utility>
+#include <vector>
+#include <unordered_set>
 
 using namespace std;
 
@@ -18,22 +24,33 @@ public:
 	int cols() const;
 	bool isValid(Point p) const;
 	Point randomPoint() const;
+	Rng& rng() const;
+	void seed(uint64_t s);
+	uint64_t lastSeed() const;
 	bool addShip(int length, char symbol, string name);
 	int nShips() const;
 	int shipLength(int shipId) const;
 	char shipSymbol(int shipId) const;
-	string shipName(int shipId) const;
-	Player* play(Player* p1, Player* p2, Board& b1, Board& b2, bool shouldPause);
+	const string& shipName(int shipId) const;
+	bool symbolInUse(char symbol) const;
+	int totalShipLength() const;
+	FleetPlacer::Result fleetFitsWith(int length);
+	Player* play(Player* p1, Player* p2, Board& b1, Board& b2, GameObserver* obs);
+	Board& board(const Game& g, int i);
 private:
-	int m_Rows, m_Cols, m_Ships;
-	struct Node {
+	int m_Rows, m_Cols, m_TotalLength;
+	mutable Rng m_rng;
+	uint64_t m_seed;
+	struct ShipInfo {
 		int mLength;
 		char mSymbol;
 		string mName;
-		int ID;
-		Node* next;
 	};
-	Node* head;
+	vector<ShipInfo> m_ships;			//indexed by ship ID
+	vector<int> m_lengths;				//the ships' lengths, indexed by ship ID
+	bool m_symbolUsed[256];				//indexed by symbol
+	unordered_set<string> m_names;
+	Board* m_boards[2];					//made by the first game and cleared for each one after
 };
 
 void waitForEnter()
@@ -42,20 +59,20 @@ void waitForEnter()
 	cin.ignore(10000, '\n');
 }
 
-GameImpl::GameImpl(int nRows, int nCols) : m_Rows(nRows), m_Cols(nCols), m_Ships(0)
+GameImpl::GameImpl(int nRows, int nCols) : m_Rows(nRows), m_Cols(nCols), m_TotalLength(0), m_seed(randomSeed())
 {
+	m_rng.reseed(m_seed);
+	m_boards[0] = m_boards[1] = nullptr;
 	if (nRows > MAXROWS || nCols > MAXCOLS)
 		exit(1);
-	head = nullptr; //intialize head of linked list to null
+	for (int i = 0; i < 256; i++) //no symbols in use yet
+		m_symbolUsed[i] = false;
 
 }
 
 GameImpl::~GameImpl() {
-	while (head != nullptr) { //deletes all dynamically allocated linked list members
-		Node* ptr = head;
-		head = head->next;
-		delete ptr;
-	}
+	delete m_boards[0];
+	delete m_boards[1];
 }
 
 int GameImpl::rows() const
@@ -75,7 +92,23 @@ bool GameImpl::isValid(Point p) const
 
 Point GameImpl::randomPoint() const
 {
-	return Point(randInt(rows()), randInt(cols()));
+	return Point(m_rng.nextInt(rows()), m_rng.nextInt(cols()));
+}
+
+Rng& GameImpl::rng() const
+{
+	return m_rng;
+}
+
+void GameImpl::seed(uint64_t s)
+{
+	m_seed = s;
+	m_rng.reseed(s);
+}
+
+uint64_t GameImpl::lastSeed() const
+{
+	return m_seed;
 }
 
 bool GameImpl::addShip(int length, char symbol, string name)
@@ -83,154 +116,119 @@ bool GameImpl::addShip(int length, char symbol, string name)
 	if (length <= 0 || (length > m_Rows && length > m_Cols) || symbol == 'o' || symbol == 'X' || symbol == '.') //checks for bad conditions
 		return false;
 
-	for (Node*ptr = head; ptr != nullptr; ptr = ptr->next) //checks for duplicate ships
-		if (ptr->mSymbol == symbol || ptr->mName == name)
-			return false;
+	if (symbolInUse(symbol) || m_names.count(name) != 0) //checks for duplicate ships
+		return false;
 
-	Node* p = new Node; //inserts ship as a new node in the front of the linked list
-	p->mLength = length;
-	p->mSymbol = symbol;
-	p->mName = name;
-	p->ID = m_Ships;
-	p->next = head;
-	head = p;
+	ShipInfo info; //appends ship to the registry; its ID is its index
+	info.mLength = length;
+	info.mSymbol = symbol;
+	info.mName = name;
+	m_ships.push_back(info);
+	m_lengths.push_back(length);
+	m_symbolUsed[(unsigned char)symbol] = true;
+	m_names.insert(name);
+	m_TotalLength += length;
 
-	m_Ships++;
 	return true;
 }
 
 int GameImpl::nShips() const
 {
-	return m_Ships;
+	return int(m_ships.size());
 }
 
 int GameImpl::shipLength(int shipId) const
 {
-	for (Node* ptr = head; ptr != nullptr; ptr = ptr->next) //finds corresponding ship and returns its length
-		if (ptr->ID == shipId)
-			return ptr->mLength;
-
-	return -1;
+	if (shipId < 0 || shipId >= nShips())
+		return -1;
+	return m_ships[shipId].mLength;
 }
 
 char GameImpl::shipSymbol(int shipId) const
 {
-	for (Node* ptr = head; ptr != nullptr; ptr = ptr->next) //finds corresponding ship and returns its symbol
-		if (ptr->ID == shipId)
-			return ptr->mSymbol;
+	if (shipId < 0 || shipId >= nShips())
+		return '?';
+	return m_ships[shipId].mSymbol;
+}
+
+const string& GameImpl::shipName(int shipId) const
+{
+	static const string noName;
+	if (shipId < 0 || shipId >= nShips())
+		return noName;
+	return m_ships[shipId].mName;
+}
 
-	return '?';
+bool GameImpl::symbolInUse(char symbol) const
+{
+	return m_symbolUsed[(unsigned char)symbol];
 }
 
-string GameImpl::shipName(int shipId) const
+int GameImpl::totalShipLength() const
 {
-	for (Node* ptr = head; ptr != nullptr; ptr = ptr->next) //finds corresponding ship and returns its name
-		if (ptr->ID == shipId)
-			return ptr->mName;
+	return m_TotalLength;
+}
 
-	return "";
+FleetPlacer::Result GameImpl::fleetFitsWith(int length)
+{
+	m_lengths.push_back(length);		//tried in place, so adding a ship copies no lengths
+	FleetPlacer::Result fits = checkFleetFits(m_Rows, m_Cols, m_lengths);
+	m_lengths.pop_back();
+	return fits;
 }
 
-Player* GameImpl::play(Player* p1, Player* p2, Board& b1, Board& b2, bool shouldPause)
+Player* GameImpl::play(Player* p1, Player* p2, Board& b1, Board& b2, GameObserver* obs)
 {
-	b1.clear();
-	b2.clear();
-	if (!p1->placeShips(b1) || !p2->placeShips(b2)) //returns null if either player cannot place ships
-		return nullptr;
+	if (obs != nullptr)
+		return playGame(*p1, *p2, b1, b2, *obs);
+	NullObserver none;			//a headless game skips the events entirely
+	return playGame(*p1, *p2, b1, b2, none);
+}
+
+Board& GameImpl::board(const Game& g, int i)
+{
+	if (m_boards[i] == nullptr)
+		m_boards[i] = new Board(g);
+	return *m_boards[i];
+}
+
+//******************** ConsoleObserver functions ********************
 
-	Point p;
-	bool hit, destroy, gate;
-	int Id;
-
-	for (;;) { //infinite loop
-
-		cout << p1->name() << "'s turn.  Board for " << p2->name() << ": " << endl;
-
-		if (p1->isHuman())
-			b2.display(true);		//switches between display settings based on human player or not
-		else b2.display(false);
-
-		p = p1->recommendAttack();				//first player recommends attack
-		if (b2.attack(p, hit, destroy, Id))		//second player updates board to reflect target coordinate
-			gate = true;
-		else gate = false;
-		p1->recordAttackResult(p, gate, hit, destroy, Id);	//first player records result of attack
-		p2->recordAttackByOpponent(p);						//second player records opponents atack
-
-		if (!gate)											//prints out statement based on result of attack
-			cout << p1->name() << " wasted a shot at (" << p.r << "," << p.c << ")." << endl;
-		else {
-			cout << p1->name() << " attacked (" << p.r << "," << p.c << ") and";
-			if (destroy)
-				cout << " destroyed the " << shipName(Id);
-			else if (hit)
-				cout << " hit something";
-			else cout << " missed";
-			cout << ", resulting in: " << endl;
-		}
-
-		if (p1->isHuman())							//once again displayssecond player's board after attack has been made
-			b2.display(true);
-		else b2.display(false);
-
-		if (b2.allShipsDestroyed()) {			//if all of the second player's ships are destroyed, first player won
-			if (p2->isHuman()) {
-				b1.display(false);
-			}
-
-			cout << p1->name() << " won the game!" << endl;
-
-			return p1;
-		}
-		//repeats whole process with player one and two switched
-		if (shouldPause)
-			waitForEnter();
-
-		cout << p2->name() << "'s turn.  Board for " << p1->name() << ": " << endl;
-
-		if (p2->isHuman())
-			b1.display(true);
-		else b1.display(false);
-
-		p = p2->recommendAttack();
-		if (b1.attack(p, hit, destroy, Id))
-			gate = true;
-		else gate = false;
-		p2->recordAttackResult(p, gate, hit, destroy, Id);
-		p1->recordAttackByOpponent(p);
-
-		if (!gate)
-			cout << p2->name() << " wasted a shot at (" << p.r << "," << p.c << ")." << endl;
-		else {
-			cout << p2->name() << " attacked (" << p.r << "," << p.c << ") and";
-			if (destroy)
-				cout << " destroyed the " << shipName(Id);
-			else if (hit)
-				cout << " hit something";
-			else cout << " missed";
-			cout << ", resulting in: " << endl;
-		}
-
-		if (p2->isHuman())
-			b1.display(true);
-		else b1.display(false);
-
-		if (b1.allShipsDestroyed()) {
-			if (p1->isHuman()) {
-				b2.display(false);
-			}
-
-			cout << p2->name() << " won the game!" << endl;
-
-			return p2;
-		}
-
-		if (shouldPause)
-			waitForEnter();
+void ConsoleObserver::turnStarted(const Player& attacker, const Player& defender, const Board& defenderBoard)
+{
+	cout << attacker.name() << "'s turn.  Board for " << defender.name() << ": " << endl;
+	defenderBoard.display(attacker.isHuman());		//switches between display settings based on human player or not
+}
 
+void ConsoleObserver::shotFired(const Player& attacker, const Player& /* defender */, const Board& defenderBoard,
+	Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
+{
+	if (!validShot)											//prints out statement based on result of attack
+		cout << attacker.name() << " wasted a shot at (" << p.r << "," << p.c << ")." << endl;
+	else {
+		cout << attacker.name() << " attacked (" << p.r << "," << p.c << ") and";
+		if (shipDestroyed)
+			cout << " destroyed the " << m_game.shipName(shipId);
+		else if (shotHit)
+			cout << " hit something";
+		else cout << " missed";
+		cout << ", resulting in: " << endl;
 	}
+	defenderBoard.display(attacker.isHuman());		//once again displays the defender's board after attack has been made
+}
 
-	return nullptr;
+void ConsoleObserver::turnEnded(const Player& /* attacker */, const Player& /* defender */)
+{
+	if (m_shouldPause)
+		waitForEnter();
+}
+
+void ConsoleObserver::gameOver(const Player& winner, const Player& loser,
+	const Board& winnerBoard, const Board& /* loserBoard */)
+{
+	if (loser.isHuman())		//shows a human loser where the winner's ships were
+		winnerBoard.display(false);
+	cout << winner.name() << " won the game!" << endl;
 }
 
 //******************** Game functions *******************************
@@ -278,6 +276,21 @@ Point Game::randomPoint() const
 	return m_impl->randomPoint();
 }
 
+void Game::seed(uint64_t s)
+{
+	m_impl->seed(s);
+}
+
+uint64_t Game::lastSeed() const
+{
+	return m_impl->lastSeed();
+}
+
+Rng& Game::rng() const
+{
+	return m_impl->rng();
+}
+
 bool Game::addShip(int length, char symbol, string name)
 {
 	if (length < 1)
@@ -303,22 +316,28 @@ bool Game::addShip(int length, char symbol, string name)
 			<< endl;
 		return false;
 	}
-	int totalOfLengths = 0;
-	for (int s = 0; s < nShips(); s++)
+	if (m_impl->symbolInUse(symbol))
 	{
-		totalOfLengths += shipLength(s);
-		if (shipSymbol(s) == symbol)
-		{
-			cout << "Ship symbol " << symbol
-				<< " must not be used for more than one ship" << endl;
-			return false;
-		}
+		cout << "Ship symbol " << symbol
+			<< " must not be used for more than one ship" << endl;
+		return false;
 	}
-	if (totalOfLengths + length > rows() * cols())
+	if (m_impl->totalShipLength() + length > rows() * cols())
 	{
 		cout << "Board is too small to fit all ships" << endl;
 		return false;
 	}
+	FleetPlacer::Result fits = m_impl->fleetFitsWith(length);		//the area can suffice while the shapes do not
+	if (fits == FleetPlacer::INFEASIBLE)
+	{
+		cout << "The ships cannot all be placed on the board" << endl;
+		return false;
+	}
+	if (fits == FleetPlacer::GAVE_UP)
+	{
+		cout << "The ships could not be shown to fit on the board" << endl;
+		return false;
+	}
 	return m_impl->addShip(length, symbol, name);
 }
 
@@ -339,17 +358,21 @@ char Game::shipSymbol(int shipId) const
 	return m_impl->shipSymbol(shipId);
 }
 
-string Game::shipName(int shipId) const
+const string& Game::shipName(int shipId) const
 {
 	assert(shipId >= 0 && shipId < nShips());
 	return m_impl->shipName(shipId);
 }
 
 Player* Game::play(Player* p1, Player* p2, bool shouldPause)
+{
+	ConsoleObserver console(*this, shouldPause);
+	return play(p1, p2, &console);
+}
+
+Player* Game::play(Player* p1, Player* p2, GameObserver* observer)
 {
 	if (p1 == nullptr || p2 == nullptr || nShips() == 0)
 		return nullptr;
-	Board b1(*this);
-	Board b2(*this);
-	return m_impl->play(p1, p2, b1, b2, shouldPause);
+	return m_impl->play(p1, p2, m_impl->board(*this, 0), m_impl->board(*this, 1), observer);
 }
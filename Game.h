@@ -3,10 +3,13 @@
 
 #include <string>
 #include <cassert>
+#include <cstdint>
 
 class Point;
 class Player;
+class Rng;
 class GameImpl;
+class GameObserver;
 
 class Game
 {
@@ -17,12 +20,23 @@ public:
 	int cols() const;
 	bool isValid(Point p) const;
 	Point randomPoint() const;
+	// Restarts the game's random number generator from the given seed.  A
+	// new game is seeded unpredictably.
+	void seed(uint64_t s);
+	// The seed the generator was last restarted from
+	uint64_t lastSeed() const;
+	// The generator behind randomPoint, board blocking and player seeding
+	Rng& rng() const;
 	bool addShip(int length, char symbol, std::string name);
 	int nShips() const;
 	int shipLength(int shipId) const;
 	char shipSymbol(int shipId) const;
-	std::string shipName(int shipId) const;
+	const std::string& shipName(int shipId) const;
 	Player* play(Player* p1, Player* p2, bool shouldPause = true);
+	// Plays without console output, reporting events to observer if it is
+	// not null.  The game keeps its two boards from one call to the next, so
+	// seeding it and resetting the players readies it for another game.
+	Player* play(Player* p1, Player* p2, GameObserver* observer);
 	// We prevent a Game object from being copied or assigned
 	Game(const Game&) = delete;
 	Game& operator=(const Game&) = delete;
@@ -0,0 +1,242 @@
+#include "GameBatch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+using namespace std;
+
+GameBatch::GameBatch(const CompactFleet& f, int nGames) : m_fleet(f), m_nGames(nGames), m_toMove(0)
+{
+	for (int side = 0; side < 2; side++) {
+		Lanes& b = m_board[side];
+		b.shipsLo.assign(nGames, 0);
+		b.shipsHi.assign(nGames, 0);
+		b.shotsLo.assign(nGames, 0);
+		b.shotsHi.assign(nGames, 0);
+		for (int k = 0; k < m_fleet.nShips; k++) {
+			b.maskLo[k].assign(nGames, 0);
+			b.maskHi[k].assign(nGames, 0);
+			b.health[k].assign(nGames, 0);
+		}
+		b.cellsLeft.assign(nGames, 0);
+		Players& p = m_player[side];
+		p.kind = CompactPlayer::AWFUL;
+		p.rng.assign(nGames, Rng());
+		p.state.assign(nGames, 1);
+		p.lastCell.assign(nGames, 0);
+		m_shots[side].assign(nGames, 0);
+	}
+	m_active.assign(nGames, 0);
+	m_winner.assign(nGames, -1);
+	m_target.assign(nGames, 0);
+	m_valid.assign(nGames, 0);
+	m_hit.assign(nGames, 0);
+	m_sunk.assign(nGames, -1);
+}
+
+int GameBatch::start(CompactPlayer::Kind k0, CompactPlayer::Kind k1, uint64_t seed)
+{
+	m_player[0].kind = k0;
+	m_player[1].kind = k1;
+	m_toMove = 0;
+	int failures = 0;
+	for (int g = 0; g < m_nGames; g++) {
+		CompactGame game;				//places the fleets as a compact game would, then spreads it into the lanes
+		bool ok = game.start(m_fleet, k0, k1, mixSeed(seed, g), m_placer);
+		m_active[g] = (ok ? ~uint64_t(0) : 0);
+		m_winner[g] = -1;
+		failures += !ok;
+		for (int side = 0; side < 2; side++) {
+			const CompactBoard& cb = game.board[side];
+			Lanes& b = m_board[side];
+			b.shipsLo[g] = cb.ships.w[0];
+			b.shipsHi[g] = cb.ships.w[1];
+			b.shotsLo[g] = b.shotsHi[g] = 0;
+			b.cellsLeft[g] = cb.cellsLeft;
+			for (int k = 0; k < m_fleet.nShips; k++) {
+				CellMask m;
+				m.clear();
+				int step = ((cb.vertical >> k) & 1) ? m_fleet.cols : 1;
+				for (int i = 0; ok && i < m_fleet.length[k]; i++)
+					m.set(cb.start[k] + i * step);
+				b.maskLo[k][g] = m.w[0];
+				b.maskHi[k][g] = m.w[1];
+				b.health[k][g] = (ok ? cb.health[k] : 0);
+			}
+			Players& p = m_player[side];
+			p.rng[g] = game.player[side].rng;
+			p.state[g] = game.player[side].state;
+			p.lastCell[g] = game.player[side].lastCell;
+			m_shots[side][g] = 0;
+		}
+	}
+	return failures;
+}
+
+const char* GameBatch::instructionSet()
+{
+#if defined(__AVX2__)
+	return "AVX2";
+#elif defined(__SSE4_1__)
+	return "SSE4.1";
+#else
+	return "scalar";
+#endif
+}
+
+void GameBatch::chooseTargets(Players& p, const Lanes& target)
+{
+	int cells = m_fleet.cells;
+	if (p.kind == CompactPlayer::AWFUL) {		//walks backward through the cells; simple enough for the compiler to vectorize
+		for (int g = 0; g < m_nGames; g++) {
+			uint8_t next = uint8_t(p.lastCell[g] == 0 ? cells - 1 : p.lastCell[g] - 1);
+			p.lastCell[g] = (m_active[g] != 0 ? next : p.lastCell[g]);
+			m_target[g] = p.lastCell[g];
+		}
+		return;
+	}
+	for (int g = 0; g < m_nGames; g++) {
+		if (m_active[g] == 0)
+			continue;
+		CellMask shots;
+		shots.w[0] = target.shotsLo[g];
+		shots.w[1] = target.shotsHi[g];
+		m_target[g] = mediocreAttack(m_fleet, p.rng[g], p.state[g], p.lastCell[g], shots);
+	}
+}
+
+// Resolves games first through last - 1 one at a time, as Board::attack does
+void GameBatch::resolveScalar(Lanes& b, int first, int last)
+{
+	for (int g = first; g < last; g++) {
+		uint64_t cell = m_target[g];
+		uint64_t bitLo = (cell < 64 ? uint64_t(1) << cell : 0);
+		uint64_t bitHi = (cell >= 64 && cell < 128 ? uint64_t(1) << (cell - 64) : 0);
+		bool valid = m_active[g] != 0 && cell < uint64_t(m_fleet.cells) &&
+			((b.shotsLo[g] & bitLo) | (b.shotsHi[g] & bitHi)) == 0;
+		m_valid[g] = (valid ? ~uint64_t(0) : 0);
+		m_hit[g] = 0;
+		m_sunk[g] = -1;
+		if (!valid)
+			continue;
+		b.shotsLo[g] |= bitLo;
+		b.shotsHi[g] |= bitHi;
+		if (((b.shipsLo[g] & bitLo) | (b.shipsHi[g] & bitHi)) == 0)
+			continue;
+		m_hit[g] = ~uint64_t(0);
+		b.cellsLeft[g]--;
+		for (int k = 0; k < m_fleet.nShips; k++)
+			if (((b.maskLo[k][g] & bitLo) | (b.maskHi[k][g] & bitHi)) != 0 && --b.health[k][g] == 0)
+				m_sunk[g] = k;
+	}
+}
+
+// Resolves the shots of games first through last - 1.  Each lane builds the
+// shot's bit in both halves of the board, tests and sets it in the shot
+// masks, and takes a cell of health from whichever ship it hit, with no
+// branches, so every lane does the same work.
+void GameBatch::resolve(Lanes& b, int first, int last)
+{
+	int g = first;
+#if defined(__AVX2__)
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi64x(1);
+	const __m256i sixtyFour = _mm256_set1_epi64x(64);
+	const __m256i cells = _mm256_set1_epi64x(m_fleet.cells);
+	for (; g + 4 <= last; g += 4) {
+#define LOAD(v) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&(v)[g]))
+#define STORE(v, x) _mm256_storeu_si256(reinterpret_cast<__m256i*>(&(v)[g]), x)
+		__m256i cell = LOAD(m_target);
+		__m256i bitLo = _mm256_sllv_epi64(one, cell);			//a shift of 64 or more gives 0
+		__m256i bitHi = _mm256_sllv_epi64(one, _mm256_sub_epi64(cell, sixtyFour));
+		__m256i shotsLo = LOAD(b.shotsLo), shotsHi = LOAD(b.shotsHi);
+		__m256i taken = _mm256_or_si256(_mm256_and_si256(shotsLo, bitLo), _mm256_and_si256(shotsHi, bitHi));
+		__m256i valid = _mm256_and_si256(_mm256_and_si256(LOAD(m_active), _mm256_cmpgt_epi64(cells, cell)),
+			_mm256_cmpeq_epi64(taken, zero));
+		STORE(b.shotsLo, _mm256_or_si256(shotsLo, _mm256_and_si256(bitLo, valid)));
+		STORE(b.shotsHi, _mm256_or_si256(shotsHi, _mm256_and_si256(bitHi, valid)));
+		__m256i onShip = _mm256_or_si256(_mm256_and_si256(LOAD(b.shipsLo), bitLo), _mm256_and_si256(LOAD(b.shipsHi), bitHi));
+		__m256i hit = _mm256_andnot_si256(_mm256_cmpeq_epi64(onShip, zero), valid);
+		STORE(b.cellsLeft, _mm256_add_epi64(LOAD(b.cellsLeft), hit));		//hit is -1 in a lane that hit
+		__m256i sunk = _mm256_set1_epi64x(-1);
+		for (int k = 0; k < m_fleet.nShips; k++) {
+			__m256i onK = _mm256_or_si256(_mm256_and_si256(LOAD(b.maskLo[k]), bitLo), _mm256_and_si256(LOAD(b.maskHi[k]), bitHi));
+			onK = _mm256_andnot_si256(_mm256_cmpeq_epi64(onK, zero), hit);
+			__m256i health = _mm256_add_epi64(LOAD(b.health[k]), onK);
+			STORE(b.health[k], health);
+			sunk = _mm256_blendv_epi8(sunk, _mm256_set1_epi64x(k), _mm256_and_si256(onK, _mm256_cmpeq_epi64(health, zero)));
+		}
+		STORE(m_valid, valid);
+		STORE(m_hit, hit);
+		STORE(m_sunk, sunk);
+#undef LOAD
+#undef STORE
+	}
+#elif defined(__SSE4_1__)
+	const __m128i zero = _mm_setzero_si128();
+	for (; g + 2 <= last; g += 2) {
+#define LOAD(v) _mm_loadu_si128(reinterpret_cast<const __m128i*>(&(v)[g]))
+#define STORE(v, x) _mm_storeu_si128(reinterpret_cast<__m128i*>(&(v)[g]), x)
+		uint64_t c0 = m_target[g], c1 = m_target[g + 1];		//SSE has no per-lane shift, so the bits are made one lane at a time
+		__m128i bitLo = _mm_set_epi64x(c1 < 64 ? int64_t(uint64_t(1) << c1) : 0, c0 < 64 ? int64_t(uint64_t(1) << c0) : 0);
+		__m128i bitHi = _mm_set_epi64x(c1 >= 64 && c1 < 128 ? int64_t(uint64_t(1) << (c1 - 64)) : 0,
+			c0 >= 64 && c0 < 128 ? int64_t(uint64_t(1) << (c0 - 64)) : 0);
+		__m128i shotsLo = LOAD(b.shotsLo), shotsHi = LOAD(b.shotsHi);
+		__m128i taken = _mm_or_si128(_mm_and_si128(shotsLo, bitLo), _mm_and_si128(shotsHi, bitHi));
+		__m128i inRange = _mm_set_epi64x(c1 < uint64_t(m_fleet.cells) ? -1 : 0, c0 < uint64_t(m_fleet.cells) ? -1 : 0);
+		__m128i valid = _mm_and_si128(_mm_and_si128(LOAD(m_active), inRange), _mm_cmpeq_epi64(taken, zero));
+		STORE(b.shotsLo, _mm_or_si128(shotsLo, _mm_and_si128(bitLo, valid)));
+		STORE(b.shotsHi, _mm_or_si128(shotsHi, _mm_and_si128(bitHi, valid)));
+		__m128i onShip = _mm_or_si128(_mm_and_si128(LOAD(b.shipsLo), bitLo), _mm_and_si128(LOAD(b.shipsHi), bitHi));
+		__m128i hit = _mm_andnot_si128(_mm_cmpeq_epi64(onShip, zero), valid);
+		STORE(b.cellsLeft, _mm_add_epi64(LOAD(b.cellsLeft), hit));
+		__m128i sunk = _mm_set1_epi64x(-1);
+		for (int k = 0; k < m_fleet.nShips; k++) {
+			__m128i onK = _mm_or_si128(_mm_and_si128(LOAD(b.maskLo[k]), bitLo), _mm_and_si128(LOAD(b.maskHi[k]), bitHi));
+			onK = _mm_andnot_si128(_mm_cmpeq_epi64(onK, zero), hit);
+			__m128i health = _mm_add_epi64(LOAD(b.health[k]), onK);
+			STORE(b.health[k], health);
+			sunk = _mm_blendv_epi8(sunk, _mm_set1_epi64x(k), _mm_and_si128(onK, _mm_cmpeq_epi64(health, zero)));
+		}
+		STORE(m_valid, valid);
+		STORE(m_hit, hit);
+		STORE(m_sunk, sunk);
+#undef LOAD
+#undef STORE
+	}
+#endif
+	resolveScalar(b, g, last);				//the games left over, or all of them without SIMD
+}
+
+int GameBatch::step()
+{
+	Players& attacker = m_player[m_toMove];
+	Lanes& target = m_board[1 - m_toMove];
+	chooseTargets(attacker, target);
+	resolve(target, 0, m_nGames);
+
+	int unfinished = 0;
+	for (int g = 0; g < m_nGames; g++) {		//reports the results to the players and scores finished games
+		if (m_active[g] == 0)
+			continue;
+		m_shots[m_toMove][g]++;
+		if (attacker.kind == CompactPlayer::MEDIOCRE)
+			mediocreRecord(attacker.state[g], attacker.lastCell[g], int(m_target[g]), m_valid[g] != 0, m_hit[g] != 0, m_sunk[g] >= 0);
+		if (target.cellsLeft[g] == 0) {
+			m_winner[g] = int8_t(m_toMove);
+			m_active[g] = 0;
+		}
+		else unfinished++;
+	}
+	m_toMove = 1 - m_toMove;
+	return unfinished;
+}
+
+void GameBatch::play()
+{
+	while (step() > 0)
+		;
+}
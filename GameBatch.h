@@ -0,0 +1,76 @@
+#ifndef GAMEBATCH_INCLUDED
+#define GAMEBATCH_INCLUDED
+
+#include "CompactGame.h"
+#include <cstdint>
+#include <vector>
+
+// Plays many independent games of one matchup in lockstep.  The games'
+// state is kept as a structure of arrays, one array per field with an
+// element per game, and each step fires one shot in every unfinished game:
+// the players pick their cells game by game, then the shots are resolved
+// against the boards four games at a time with AVX2, two at a time with
+// SSE4.1, or one at a time, whichever the compiler was allowed to use.
+// A game plays exactly as the CompactGame with the same seed would.  Only
+// the awful and mediocre strategies are batched; the good one's targets
+// are too irregular to step in lanes.
+class GameBatch
+{
+public:
+	GameBatch(const CompactFleet& f, int nGames);
+
+	// Starts every game between players of the given kinds, awful or
+	// mediocre, seeding game i with mixSeed(seed, i).  Returns the number
+	// of games in which a fleet could not be placed; those games count as
+	// finished.
+	int start(CompactPlayer::Kind k0, CompactPlayer::Kind k1, uint64_t seed);
+	// Fires one shot in every unfinished game, and returns the number of
+	// games still unfinished
+	int step();
+	// Steps until every game is finished
+	void play();
+
+	int size() const { return m_nGames; }
+	// The winner of a finished game, or -1 if its fleets were not placed
+	int winner(int game) const { return m_winner[game]; }
+	// The shots player fired in the game
+	int shots(int game, int player) const { return m_shots[player][game]; }
+
+	// "AVX2", "SSE4.1" or "scalar": how this build resolves shots
+	static const char* instructionSet();
+
+private:
+	// One side's boards, a lane per game
+	struct Lanes {
+		std::vector<uint64_t> shipsLo, shipsHi;		//cells holding a ship; cell i is bit i of lo, or bit i - 64 of hi
+		std::vector<uint64_t> shotsLo, shotsHi;
+		std::vector<uint64_t> maskLo[CompactFleet::MAXSHIPS], maskHi[CompactFleet::MAXSHIPS];	//each ship's cells
+		std::vector<uint64_t> health[CompactFleet::MAXSHIPS];
+		std::vector<uint64_t> cellsLeft;
+	};
+	// One side's players
+	struct Players {
+		CompactPlayer::Kind kind;
+		std::vector<Rng> rng;
+		std::vector<uint8_t> state, lastCell;
+	};
+	CompactFleet m_fleet;
+	CompactPlacer m_placer;
+	int m_nGames;
+	Lanes m_board[2];
+	Players m_player[2];
+	int m_toMove;
+	std::vector<uint64_t> m_active;		//all ones while a game is unfinished
+	std::vector<int8_t> m_winner;
+	std::vector<uint16_t> m_shots[2];
+	// This step's shots, and how they came out; valid and hit are all ones
+	// or zero, sunk is the ID of the ship sunk or -1
+	std::vector<uint64_t> m_target, m_valid, m_hit;
+	std::vector<int64_t> m_sunk;
+
+	void chooseTargets(Players& p, const Lanes& target);
+	void resolve(Lanes& target, int first, int last);
+	void resolveScalar(Lanes& target, int first, int last);
+};
+
+#endif // GAMEBATCH_INCLUDED
@@ -0,0 +1,56 @@
+#ifndef GAMEOBSERVER_INCLUDED
+#define GAMEOBSERVER_INCLUDED
+
+#include "globals.h"
+
+class Player;
+class Board;
+class Game;
+
+// Receives the events of a game as Game::play runs it.  Every function
+// does nothing by default, so an observer overrides only what it needs.
+// Passing a null observer to Game::play runs the game without any events
+// or output.
+class GameObserver
+{
+public:
+	virtual ~GameObserver() {}
+
+	// Both players have placed their ships
+	virtual void gameStarted(const Player& /* p1 */, const Player& /* p2 */,
+		const Board& /* b1 */, const Board& /* b2 */) {}
+	// attacker is about to shoot at the defender's board
+	virtual void turnStarted(const Player& /* attacker */, const Player& /* defender */,
+		const Board& /* defenderBoard */) {}
+	// attacker shot at p, with the result reported to the attacker
+	virtual void shotFired(const Player& /* attacker */, const Player& /* defender */,
+		const Board& /* defenderBoard */, Point /* p */, bool /* validShot */,
+		bool /* shotHit */, bool /* shipDestroyed */, int /* shipId */) {}
+	// attacker's last shot destroyed the defender's ship shipId
+	virtual void shipSunk(const Player& /* attacker */, const Player& /* defender */, int /* shipId */) {}
+	// The turn ended without destroying the defender's last ship
+	virtual void turnEnded(const Player& /* attacker */, const Player& /* defender */) {}
+	// The winner destroyed all of the loser's ships
+	virtual void gameOver(const Player& /* winner */, const Player& /* loser */,
+		const Board& /* winnerBoard */, const Board& /* loserBoard */) {}
+};
+
+// Writes the game to cout the way an interactive game shows it, optionally
+// waiting for the enter key after every turn
+class ConsoleObserver : public GameObserver
+{
+public:
+	ConsoleObserver(const Game& g, bool shouldPause) : m_game(g), m_shouldPause(shouldPause) {}
+	virtual void turnStarted(const Player& attacker, const Player& defender, const Board& defenderBoard);
+	virtual void shotFired(const Player& attacker, const Player& defender, const Board& defenderBoard,
+		Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void turnEnded(const Player& attacker, const Player& defender);
+	virtual void gameOver(const Player& winner, const Player& loser,
+		const Board& winnerBoard, const Board& loserBoard);
+
+private:
+	const Game& m_game;
+	bool m_shouldPause;
+};
+
+#endif // GAMEOBSERVER_INCLUDED
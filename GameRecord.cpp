@@ -0,0 +1,329 @@
+#include "GameRecord.h"
+#include "Game.h"
+#include "Board.h"
+#include "Player.h"
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char MAGIC[4] = { 'B', 'S', 'G', 'R' };
+const int VERSION = 1;
+const size_t HEADERSIZE = 8;
+const size_t FLUSHSIZE = 1 << 20;		//bytes of finished records written at once
+
+// Appends n little-endian bytes of v
+inline void put(vector<unsigned char>& out, uint64_t v, int n)
+{
+	for (int i = 0; i < n; i++)
+		out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+}
+
+inline uint64_t get(const unsigned char* in, int n)
+{
+	uint64_t v = 0;
+	for (int i = n - 1; i >= 0; i--)
+		v = (v << 8) | in[i];
+	return v;
+}
+
+// Packs a shot as described in GameRecord.h.  Points off a 1024x1024 board
+// can only come from invalid shots, and keep just their low 10 bits.
+inline uint32_t packShot(int player, Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
+{
+	uint32_t w = (uint32_t(p.r) & 1023) | (uint32_t(p.c) & 1023) << 10 | uint32_t(player) << 20;
+	if (!validShot)
+		return w;			//an invalid shot's other results are unspecified
+	w |= 1 << 21;
+	if (shotHit)
+		w |= 1 << 22;
+	if (shipDestroyed)
+		w |= (1 << 23) | uint32_t(shipId & 255) << 24;
+	return w;
+}
+
+}
+
+//******************** GameRecorder functions ********************************
+
+GameRecorder::GameRecorder(const Game& g) : m_game(g), m_file(nullptr), m_first(nullptr), m_firstCreated(nullptr), m_games(0)
+{
+}
+
+GameRecorder::~GameRecorder()
+{
+	close();
+}
+
+bool GameRecorder::open(const string& path)
+{
+	close();
+	if (m_game.nShips() > 255) {
+		cout << "A game record holds at most 255 ships." << endl;
+		return false;
+	}
+	m_file = fopen(path.c_str(), "wb");
+	if (m_file == nullptr) {
+		cout << "Cannot create " << path << "." << endl;
+		return false;
+	}
+	m_buffer.clear();
+	for (int i = 0; i < 4; i++)
+		m_buffer.push_back(MAGIC[i]);
+	put(m_buffer, VERSION, 2);
+	put(m_buffer, 0, 2);
+	m_games = 0;
+	return true;
+}
+
+void GameRecorder::close()
+{
+	if (m_file == nullptr)
+		return;
+	flush();
+	fclose(m_file);
+	m_file = nullptr;
+}
+
+void GameRecorder::flush()
+{
+	if (!m_buffer.empty() && fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size())
+		cout << "Could not write the game record." << endl;
+	m_buffer.clear();
+}
+
+void GameRecorder::gameStarted(const Player& p1, const Player& p2, const Board& b1, const Board& b2)
+{
+	m_first = &p1;
+	m_shots.clear();
+	m_start.clear();
+	put(m_start, m_game.lastSeed(), 8);
+	put(m_start, m_firstCreated == &p2 ? 1 : 0, 1);
+	m_firstCreated = nullptr;
+	const Player* players[2] = { &p1, &p2 };
+	for (int i = 0; i < 2; i++) {
+		const char* type = players[i]->typeName();
+		size_t n = strlen(type) < 255 ? strlen(type) : 255;
+		put(m_start, n, 1);
+		m_start.insert(m_start.end(), type, type + n);
+	}
+	put(m_start, m_game.rows(), 2);
+	put(m_start, m_game.cols(), 2);
+	put(m_start, m_game.nShips(), 1);
+	for (int k = 0; k < m_game.nShips(); k++) {
+		put(m_start, m_game.shipLength(k), 2);
+		put(m_start, static_cast<unsigned char>(m_game.shipSymbol(k)), 1);
+	}
+	const Board* boards[2] = { &b1, &b2 };
+	for (int i = 0; i < 2; i++)
+		for (int k = 0; k < m_game.nShips(); k++) {
+			Point p;
+			Direction dir = HORIZONTAL;
+			boards[i]->shipPlacement(k, p, dir);
+			put(m_start, p.r, 2);
+			put(m_start, p.c, 2);
+			put(m_start, dir, 1);
+		}
+}
+
+void GameRecorder::shotFired(const Player& attacker, const Player& /* defender */, const Board& /* defenderBoard */,
+	Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
+{
+	m_shots.push_back(packShot(&attacker == m_first ? 0 : 1, p, validShot, shotHit, shipDestroyed, shipId));
+}
+
+void GameRecorder::gameOver(const Player& winner, const Player& /* loser */,
+	const Board& /* winnerBoard */, const Board& /* loserBoard */)
+{
+	if (m_file == nullptr)
+		return;
+	put(m_buffer, m_start.size() + 5 + 4 * m_shots.size(), 4);
+	m_buffer.insert(m_buffer.end(), m_start.begin(), m_start.end());
+	put(m_buffer, &winner == m_first ? 0 : 1, 1);
+	put(m_buffer, m_shots.size(), 4);
+	for (size_t i = 0; i < m_shots.size(); i++)
+		put(m_buffer, m_shots[i], 4);
+	m_games++;
+	if (m_buffer.size() >= FLUSHSIZE)
+		flush();
+}
+
+//******************** GameRecordView functions ********************************
+
+uint64_t GameRecordView::seed() const
+{
+	return get(m_data, 8);
+}
+
+string GameRecordView::playerType(int player) const
+{
+	const unsigned char* in = m_data + 9;
+	if (player != 0)
+		in += 1 + in[0];
+	return string(reinterpret_cast<const char*>(in + 1), in[0]);
+}
+
+int GameRecordView::firstCreated() const
+{
+	return m_data[8];
+}
+
+int GameRecordView::rows() const
+{
+	return int(get(m_fleet, 2));
+}
+
+int GameRecordView::cols() const
+{
+	return int(get(m_fleet + 2, 2));
+}
+
+int GameRecordView::shipLength(int shipId) const
+{
+	return int(get(m_fleet + 5 + 3 * shipId, 2));
+}
+
+char GameRecordView::shipSymbol(int shipId) const
+{
+	return char(m_fleet[5 + 3 * shipId + 2]);
+}
+
+void GameRecordView::placement(int player, int shipId, Point& topOrLeft, Direction& dir) const
+{
+	const unsigned char* in = placements() + 5 * (player * m_nShips + shipId);
+	topOrLeft = Point(int(get(in, 2)), int(get(in + 2, 2)));
+	dir = (in[4] == VERTICAL ? VERTICAL : HORIZONTAL);
+}
+
+int GameRecordView::winner() const
+{
+	return placements()[10 * m_nShips];
+}
+
+int GameRecordView::nShots() const
+{
+	return int(get(placements() + 10 * m_nShips + 1, 4));
+}
+
+RecordedShot GameRecordView::shot(int i) const
+{
+	uint32_t w = uint32_t(get(shots() + 4 * i, 4));
+	RecordedShot s;
+	s.p = Point(w & 1023, (w >> 10) & 1023);
+	s.player = (w >> 20) & 1;
+	s.validShot = (w >> 21) & 1;
+	s.shotHit = (w >> 22) & 1;
+	s.shipDestroyed = (w >> 23) & 1;
+	s.shipId = (s.shipDestroyed ? int(w >> 24) : -1);
+	return s;
+}
+
+//******************** GameRecordReader functions ********************************
+
+GameRecordReader::GameRecordReader() : m_data(nullptr), m_size(0), m_pos(0), m_mapped(false)
+{
+}
+
+GameRecordReader::~GameRecordReader()
+{
+	close();
+}
+
+bool GameRecordReader::open(const string& path)
+{
+	close();
+#ifndef _WIN32
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		cout << "Cannot open " << path << "." << endl;
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);
+			m_data = static_cast<const unsigned char*>(p);
+			m_size = size_t(st.st_size);
+			m_mapped = true;
+		}
+	}
+	::close(fd);
+#else
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == nullptr) {
+		cout << "Cannot open " << path << "." << endl;
+		return false;
+	}
+	unsigned char block[1 << 16];
+	size_t n;
+	while ((n = fread(block, 1, sizeof(block), f)) > 0)
+		m_copy.insert(m_copy.end(), block, block + n);
+	fclose(f);
+	m_data = m_copy.data();
+	m_size = m_copy.size();
+#endif
+	if (m_size < HEADERSIZE || memcmp(m_data, MAGIC, 4) != 0 || get(m_data + 4, 2) != VERSION) {
+		cout << path << " is not a game record file." << endl;
+		close();
+		return false;
+	}
+	m_pos = HEADERSIZE;
+	return true;
+}
+
+void GameRecordReader::close()
+{
+#ifndef _WIN32
+	if (m_mapped)
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+	m_copy.clear();
+	m_data = nullptr;
+	m_size = m_pos = 0;
+	m_mapped = false;
+}
+
+bool GameRecordReader::next(GameRecordView& view)
+{
+	if (m_pos + 4 > m_size)
+		return false;
+	size_t size = size_t(get(m_data + m_pos, 4));
+	const unsigned char* rec = m_data + m_pos + 4;
+	if (size < 11 || size > m_size - m_pos - 4)
+		return false;
+	size_t types = 2 + rec[9];					//the bytes of the player types
+	if (size < 9 + types)
+		return false;
+	types += rec[10 + rec[9]];
+	size_t fixed = types + 19;					//the record without its ships and shots
+	if (size < fixed)
+		return false;
+	const unsigned char* fleet = rec + 9 + types;
+	int nShips = fleet[4];
+	if (size < fixed + 13 * nShips)
+		return false;
+	size_t nShots = size_t(get(fleet + 5 + 13 * nShips + 1, 4));
+	if (size != fixed + 13 * nShips + 4 * nShots)
+		return false;
+	view.m_data = rec;
+	view.m_fleet = fleet;
+	view.m_nShips = nShips;
+	m_pos += 4 + size;
+	return true;
+}
+
+void GameRecordReader::rewind()
+{
+	if (m_data != nullptr)
+		m_pos = HEADERSIZE;
+}
@@ -0,0 +1,148 @@
+#ifndef GAMERECORD_INCLUDED
+#define GAMERECORD_INCLUDED
+
+#include "GameObserver.h"
+#include "globals.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Game;
+
+// A compact binary format for played games.  A file is the four bytes
+// "BSGR", a 16-bit version and 16 reserved bits, then one record per game.
+// All numbers are little-endian.  A record is:
+//
+//   u32  size of the rest of the record, in bytes
+//   u64  the game's seed (Game::lastSeed when the ships were placed)
+//   u8   1 if player 0 was created (or reset) after player 1, else 0
+//   per player: u8 length, then the characters of its Player::typeName
+//   u16  rows, u16 cols, u8 number of ships
+//   per ship: u16 length, u8 symbol
+//   per player, per ship: u16 row, u16 column, u8 direction
+//   u8   the winner, 0 or 1
+//   u32  number of shots
+//   per shot: u32 with the row in bits 0-9, the column in bits 10-19, the
+//        attacker in bit 20, then bits for a valid shot, a hit and a ship
+//        destroyed, and the destroyed ship's ID in bits 24-31
+//
+// Player 0 is the player who moved first.  The order the players were
+// created in decides which of the game's random numbers seeded each, so a
+// record holds what is needed to replay it.
+
+struct RecordedShot
+{
+	int player;
+	Point p;
+	bool validShot, shotHit, shipDestroyed;
+	int shipId;				//the ship destroyed, or -1
+};
+
+// Writes games to a record file as they are played.  Pass it to Game::play
+// as the observer, or to playGame in PlayLoop.h.  A game costs a word per
+// shot while it is played, and the finished records are written in large
+// blocks.  A game that never reaches gameOver is not written.
+class GameRecorder : public GameObserver
+{
+public:
+	GameRecorder(const Game& g);
+	~GameRecorder();
+
+	// Starts a new file at path, or returns false if it cannot be created
+	bool open(const std::string& path);
+	// Writes out the records still buffered and closes the file
+	void close();
+	// Notes that p was created (or reset) before the other player of the
+	// next game.  Unless told so before a game, the recorder takes the
+	// player moving first, Game::play's p1, to have been created first.
+	void setFirstCreated(const Player& p) { m_firstCreated = &p; }
+
+	virtual void gameStarted(const Player& p1, const Player& p2, const Board& b1, const Board& b2);
+	virtual void shotFired(const Player& attacker, const Player& defender, const Board& defenderBoard,
+		Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void gameOver(const Player& winner, const Player& loser,
+		const Board& winnerBoard, const Board& loserBoard);
+
+	long long games() const { return m_games; }
+
+	// We prevent a GameRecorder object from being copied or assigned
+	GameRecorder(const GameRecorder&) = delete;
+	GameRecorder& operator=(const GameRecorder&) = delete;
+
+private:
+	const Game& m_game;
+	std::FILE* m_file;
+	std::vector<unsigned char> m_buffer;	//finished records not yet written
+	std::vector<unsigned char> m_start;		//the current game's record up to the shots
+	std::vector<uint32_t> m_shots;			//the current game's shots
+	const Player* m_first;
+	const Player* m_firstCreated;
+	long long m_games;
+
+	void flush();
+};
+
+// One game in a mapped record file.  Nothing is decoded until asked for,
+// so scanning records for a few fields is cheap.
+class GameRecordView
+{
+public:
+	GameRecordView() : m_data(nullptr), m_fleet(nullptr), m_nShips(0) {}
+
+	uint64_t seed() const;
+	// The type of player 0 or 1, as Player::typeName gave it
+	std::string playerType(int player) const;
+	// 0 if player 0 was created (or reset) first, 1 if player 1 was
+	int firstCreated() const;
+	int rows() const;
+	int cols() const;
+	int nShips() const { return m_nShips; }
+	int shipLength(int shipId) const;
+	char shipSymbol(int shipId) const;
+	void placement(int player, int shipId, Point& topOrLeft, Direction& dir) const;
+	int winner() const;
+	int nShots() const;
+	RecordedShot shot(int i) const;
+
+private:
+	friend class GameRecordReader;
+	const unsigned char* m_data;		//the record's seed
+	const unsigned char* m_fleet;		//the record's rows
+	int m_nShips;
+	const unsigned char* placements() const { return m_fleet + 5 + 3 * m_nShips; }
+	const unsigned char* shots() const { return placements() + 10 * m_nShips + 5; }
+};
+
+// Reads a record file, mapping it into memory where the platform allows
+// (POSIX mmap; elsewhere, such as _WIN32, the file is read into memory).
+class GameRecordReader
+{
+public:
+	GameRecordReader();
+	~GameRecordReader();
+
+	// Opens the file, or returns false if it cannot be read or is not a
+	// record file
+	bool open(const std::string& path);
+	void close();
+
+	// Sets view to the next game and returns true, or returns false at the
+	// end of the file or at a damaged record
+	bool next(GameRecordView& view);
+	// Goes back to the first game
+	void rewind();
+
+	// We prevent a GameRecordReader object from being copied or assigned
+	GameRecordReader(const GameRecordReader&) = delete;
+	GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+private:
+	const unsigned char* m_data;
+	size_t m_size;
+	size_t m_pos;
+	bool m_mapped;
+	std::vector<unsigned char> m_copy;		//the file's contents when it is not mapped
+};
+
+#endif // GAMERECORD_INCLUDED
@@ -0,0 +1,39 @@
+#ifndef GRID_INCLUDED
+#define GRID_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+// A rows x cols array stored densely in row-major order.  Its memory is
+// sized to the board actually in use rather than to MAXROWS x MAXCOLS.
+template <typename T>
+class Grid
+{
+public:
+	Grid() : m_rows(0), m_cols(0) {}
+	Grid(int rows, int cols, const T& value = T()) { resize(rows, cols, value); }
+
+	void resize(int rows, int cols, const T& value = T())
+	{
+		m_rows = rows;
+		m_cols = cols;
+		m_cells.assign(size_t(rows) * cols, value);
+	}
+	void fill(const T& value) { m_cells.assign(m_cells.size(), value); }
+
+	int rows() const { return m_rows; }
+	int cols() const { return m_cols; }
+
+	T& operator()(int r, int c) { return m_cells[size_t(r) * m_cols + c]; }
+	const T& operator()(int r, int c) const { return m_cells[size_t(r) * m_cols + c]; }
+
+	T* data() { return m_cells.data(); }
+	const T* data() const { return m_cells.data(); }
+	size_t bytes() const { return m_cells.capacity() * sizeof(T); }
+
+private:
+	int m_rows, m_cols;
+	std::vector<T> m_cells;
+};
+
+#endif // GRID_INCLUDED
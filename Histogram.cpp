@@ -0,0 +1,44 @@
+#include "Histogram.h"
+
+void LatencyHistogram::clear()
+{
+	for (int b = 0; b < NBUCKETS; b++)
+		m_counts[b] = 0;
+	m_count = 0;
+	m_sum = m_max = 0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& o)
+{
+	for (int b = 0; b < NBUCKETS; b++)
+		m_counts[b] += o.m_counts[b];
+	m_count += o.m_count;
+	m_sum += o.m_sum;
+	if (o.m_max > m_max)
+		m_max = o.m_max;
+}
+
+uint64_t LatencyHistogram::bucketTop(int b)
+{
+	if (b < 2 * SUBCOUNT)
+		return uint64_t(b);
+	int shift = b / SUBCOUNT - 1;
+	uint64_t sub = uint64_t(b % SUBCOUNT + SUBCOUNT);
+	return ((sub + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const
+{
+	if (m_count == 0)
+		return 0;
+	long long rank = (long long)(q * m_count + 0.5);		//the number of values at or below the answer
+	if (rank < 1)
+		rank = 1;
+	long long seen = 0;
+	for (int b = 0; b < NBUCKETS; b++) {
+		seen += m_counts[b];
+		if (seen >= rank)
+			return bucketTop(b) < m_max ? bucketTop(b) : m_max;
+	}
+	return m_max;
+}
@@ -0,0 +1,69 @@
+#ifndef HISTOGRAM_INCLUDED
+#define HISTOGRAM_INCLUDED
+
+#include <cstdint>
+
+// Counts durations in nanoseconds in buckets whose width grows with the
+// value, in the manner of HDR histograms: values below 64 get a bucket
+// each, and every power of two above that is split into 32 buckets, so a
+// value's bucket is never wider than 1/32 of it.  Adding a value is a few
+// instructions and never allocates; histograms kept apart, such as one per
+// thread, are combined with merge.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram() { clear(); }
+	void clear();
+	void add(uint64_t ns)
+	{
+		m_counts[bucket(ns)]++;
+		m_count++;
+		m_sum += ns;
+		if (ns > m_max)
+			m_max = ns;
+	}
+	// Adds o's values to this histogram's
+	void merge(const LatencyHistogram& o);
+
+	long long count() const { return m_count; }
+	double mean() const { return m_count == 0 ? 0 : double(m_sum) / m_count; }
+	uint64_t max() const { return m_max; }
+	// The value that the fraction q (0 to 1) of the values do not exceed,
+	// rounded up to the top of its bucket, or 0 if there are no values
+	uint64_t percentile(double q) const;
+
+private:
+	enum {
+		SUBBITS = 5,
+		SUBCOUNT = 1 << SUBBITS,						//buckets per power of two
+		NBUCKETS = 2 * SUBCOUNT + (63 - SUBBITS) * SUBCOUNT
+	};
+	long long m_counts[NBUCKETS];
+	long long m_count;
+	uint64_t m_sum, m_max;
+
+	static int highestBit(uint64_t v)
+	{
+#if defined(__GNUC__)
+		return 63 - __builtin_clzll(v);
+#else
+		int n = 0;
+		while (v >>= 1)
+			n++;
+		return n;
+#endif
+	}
+
+	static int bucket(uint64_t v)
+	{
+		if (v < 2 * SUBCOUNT)
+			return int(v);
+		int shift = highestBit(v) - SUBBITS;		//leaves v >> shift from SUBCOUNT to 2 * SUBCOUNT - 1
+		return (shift + 1) * SUBCOUNT + int(v >> shift) - SUBCOUNT;
+	}
+
+	// The largest value in bucket b
+	static uint64_t bucketTop(int b);
+};
+
+#endif // HISTOGRAM_INCLUDED
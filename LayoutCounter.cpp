@@ -0,0 +1,355 @@
+#include "LayoutCounter.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+	const int MAXCELLS = 100;
+	const int MAXSHIPS = 8;
+	const uint64_t WINDOW = (uint64_t(1) << 56) - 1;		//the covered-cell bits of a state
+
+	inline size_t slotHash(uint64_t s, size_t mask)
+	{
+		s *= 0x9E3779B97F4A7C15ULL;
+		return size_t(s ^ (s >> 32)) & mask;
+	}
+
+	inline int popCount(uint64_t w)
+	{
+#if defined(__GNUC__)
+		return __builtin_popcountll(w);
+#else
+		int n = 0;
+		for (; w != 0; w &= w - 1)
+			n++;
+		return n;
+#endif
+	}
+}
+
+void LayoutCounter::Layer::clear(size_t expected)
+{
+	size_t capacity = 16;
+	while (capacity < 2 * expected)
+		capacity <<= 1;
+	forward.assign(capacity, 0);			//only an empty slot's forward count is read
+	state.resize(capacity);
+	backward.resize(capacity);
+	size = 0;
+}
+
+void LayoutCounter::Layer::add(uint64_t s, uint64_t ways)
+{
+	if (2 * (size + 1) > state.size()) {		//keeps the table at most half full
+		Layer bigger;
+		bigger.clear(state.size());
+		for (size_t i = 0; i < state.size(); i++)
+			if (forward[i] != 0)
+				bigger.add(state[i], forward[i]);
+		swap(*this, bigger);
+	}
+	size_t mask = state.size() - 1;
+	size_t i = slotHash(s, mask);
+	while (forward[i] != 0 && state[i] != s)
+		i = (i + 1) & mask;
+	if (forward[i] == 0) {
+		state[i] = s;
+		size++;
+	}
+	forward[i] += ways;
+}
+
+size_t LayoutCounter::Layer::find(uint64_t s) const
+{
+	size_t mask = state.size() - 1;
+	for (size_t i = slotHash(s, mask); forward[i] != 0; i = (i + 1) & mask)
+		if (state[i] == s)
+			return i;
+	return state.size();
+}
+
+bool LayoutCounter::setGame(int rows, int cols, const vector<int>& lengths)
+{
+	int longest = 0;
+	for (size_t k = 0; k < lengths.size(); k++)
+		longest = max(longest, lengths[k]);
+	if (rows * cols > MAXCELLS || lengths.empty() || int(lengths.size()) > MAXSHIPS ||
+		(longest - 1) * cols >= MASKSHIFT || longest > MASKSHIFT) {
+		m_rows = m_cols = 0;
+		return false;
+	}
+
+	m_rows = rows;
+	m_cols = cols;
+	m_cells = rows * cols;
+	m_lengths = lengths;
+	m_board.resize(rows, cols, '.');
+	m_sunkAt.assign(lengths.size(), -1);
+	int n = int(lengths.size());
+	m_kinds.reserve(n);
+	m_valid.assign(size_t(n) * 2 * m_cells, 0);		//there are never more kinds than ships
+	m_wasValid.assign(m_valid.size(), 0);
+	m_shape.assign(size_t(n) * 2, 0);
+	m_weight.assign(m_valid.size(), 0);
+	m_moves.resize(1 + 2 * n);
+	m_occupancy.resize(rows, cols, 0);
+
+	m_lastStart.assign(n, -1);
+	m_fleetLength = 0;
+	for (int k = 0; k < n; k++)
+		m_fleetLength += lengths[k];
+
+	m_layers.assign(m_cells + 1, Layer());
+	reset();
+	return true;
+}
+
+void LayoutCounter::reset()
+{
+	if (m_rows == 0)
+		return;
+	m_board.fill('.');
+	fill(m_sunkAt.begin(), m_sunkAt.end(), -1);
+	setKinds();
+	for (int p = 0; p <= m_cells; p++) {		//frees the last game's tables
+		m_layers[p] = Layer();
+		m_layers[p].clear(0);
+	}
+	m_layers[0].add(0, 1);				//no ships placed and nothing covered
+	m_total = 0;
+	m_dirty = 0;
+	m_tooBig = 0;
+}
+
+// Groups the ships afloat by length and makes each sunk ship a kind of its
+// own, with a bit field wide enough for its count
+void LayoutCounter::setKinds()
+{
+	m_kinds.clear();
+	m_kindLayouts = 1;
+	for (int k = 0; k < int(m_lengths.size()); k++) {
+		size_t g = 0;
+		if (m_sunkAt[k] < 0)
+			while (g < m_kinds.size() && (m_kinds[g].sunkAt >= 0 || m_kinds[g].length != m_lengths[k]))
+				g++;
+		else g = m_kinds.size();
+		if (g == m_kinds.size()) {
+			Kind kind;
+			kind.length = m_lengths[k];
+			kind.ships = 0;
+			kind.sunkAt = m_sunkAt[k];
+			m_kinds.push_back(kind);
+		}
+		m_kinds[g].ships++;
+		m_kindLayouts *= m_kinds[g].ships;		//n ships of a kind can be swapped in n! ways
+	}
+	int shift = 0;
+	for (size_t g = 0; g < m_kinds.size(); g++) {
+		Kind& kind = m_kinds[g];
+		kind.width = 1;
+		while ((1 << kind.width) <= kind.ships)
+			kind.width++;
+		kind.shift = shift;
+		shift += kind.width;
+		m_shape[2 * g + HORIZONTAL] = m_shape[2 * g + VERTICAL] = 0;
+		for (int i = 0; i < kind.length; i++) {
+			m_shape[2 * g + HORIZONTAL] |= uint64_t(1) << i;
+			m_shape[2 * g + VERTICAL] |= uint64_t(1) << (i * m_cols);
+		}
+	}
+}
+
+void LayoutCounter::markDirty(int cell)
+{
+	if (cell < 0)
+		cell = 0;
+	if (cell <= m_dirty) {
+		m_dirty = cell;
+		m_tooBig = 0;				//the layer that was too big may have changed
+	}
+}
+
+void LayoutCounter::recordShot(Point p, bool hit)
+{
+	if (m_rows == 0)
+		return;
+	m_board(p.r, p.c) = (hit ? 'X' : 'o');
+	if (hit)
+		markDirty(p.r * m_cols + p.c);		//the cell must be covered; update finds the placements that changed
+}
+
+void LayoutCounter::recordSunk(Point p, int shipId)
+{
+	if (m_rows == 0)
+		return;
+	m_sunkAt[shipId] = p.r * m_cols + p.c;
+	setKinds();
+	markDirty(0);			//the kinds, and so every state, change
+}
+
+bool LayoutCounter::placementFits(int kind, Direction dir, int cell) const
+{
+	const Kind& k = m_kinds[kind];
+	int length = k.length;
+	int r = cell / m_cols, c = cell % m_cols;
+	if (dir == VERTICAL && (length == 1 || r + length > m_rows))		//a one-cell ship is counted once, as horizontal
+		return false;
+	if (dir == HORIZONTAL && c + length > m_cols)
+		return false;
+	int hits = 0;
+	bool coversSinking = false;
+	for (int i = 0; i < length; i++) {
+		int rr = (dir == HORIZONTAL ? r : r + i), cc = (dir == HORIZONTAL ? c + i : c);
+		if (m_board(rr, cc) == 'o')
+			return false;
+		if (m_board(rr, cc) == 'X')
+			hits++;
+		if (rr * m_cols + cc == k.sunkAt)
+			coversSinking = true;
+	}
+	if (k.sunkAt >= 0)
+		return hits == length && coversSinking;
+	return hits < length;
+}
+
+// Finds where each kind fits, and marks dirty the first cell where that
+// changed since the last count, or where a kind's last start moved
+void LayoutCounter::setValidity()
+{
+	m_valid.swap(m_wasValid);
+	for (int g = 0; g < int(m_kinds.size()); g++) {
+		int lastStart = -1;
+		for (int d = 0; d < 2; d++)
+			for (int cell = 0; cell < m_cells; cell++) {
+				int idx = (2 * g + d) * m_cells + cell;
+				m_valid[idx] = placementFits(g, Direction(d), cell);
+				if (m_valid[idx] != m_wasValid[idx])
+					markDirty(cell);
+				if (m_valid[idx])
+					lastStart = max(lastStart, cell);
+			}
+		if (lastStart != m_lastStart[g])		//canFinish drops states from the earlier of the two on
+			markDirty(min(lastStart, m_lastStart[g]));
+		m_lastStart[g] = lastStart;
+	}
+}
+
+// Returns false if the state at the cell cannot lead to a whole layout: a
+// kind with ships still to place has no place left to start, or the ships
+// still to place need more cells than remain uncovered
+bool LayoutCounter::canFinish(int cell, uint64_t state) const
+{
+	int needed = m_fleetLength;
+	for (int g = 0; g < int(m_kinds.size()); g++) {
+		const Kind& kind = m_kinds[g];
+		int placed = int(state >> (MASKSHIFT + kind.shift)) & ((1 << kind.width) - 1);
+		needed -= placed * kind.length;
+		if (placed < kind.ships && m_lastStart[g] < cell)
+			return false;
+	}
+	return needed <= m_cells - cell - popCount(state & WINDOW);
+}
+
+// Sets out to the moves from the state at the cell and returns how many
+// there are
+int LayoutCounter::moves(int cell, uint64_t state, Move* out) const
+{
+	uint64_t window = state & WINDOW;
+	uint64_t kinds = state & ~WINDOW;
+	int n = 0;
+	if (window & 1) {				//an earlier ship covers the cell
+		out[n].next = kinds | (window >> 1);
+		out[n++].placement = -1;
+		return n;
+	}
+	if (m_board(cell / m_cols, cell % m_cols) != 'X') {		//a hit must be covered
+		out[n].next = kinds | (window >> 1);
+		out[n++].placement = -1;
+	}
+	for (int g = 0; g < int(m_kinds.size()); g++) {
+		const Kind& kind = m_kinds[g];
+		if ((int(state >> (MASKSHIFT + kind.shift)) & ((1 << kind.width) - 1)) == kind.ships)
+			continue;
+		for (int d = 0; d < 2; d++) {
+			int idx = (2 * g + d) * m_cells + cell;
+			uint64_t shape = m_shape[2 * g + d];
+			if (!m_valid[idx] || (window & shape) != 0)
+				continue;
+			out[n].next = (kinds + (uint64_t(1) << (MASKSHIFT + kind.shift))) | ((window | shape) >> 1);
+			out[n++].placement = idx;
+		}
+	}
+	return n;
+}
+
+bool LayoutCounter::update(size_t maxStates)
+{
+	if (m_rows == 0)
+		return false;
+	setValidity();
+	if (m_dirty >= m_cells)
+		return true;
+	if (m_tooBig > maxStates)		//nothing the layer depends on has changed
+		return false;
+	Move* mv = &m_moves[0];
+
+	for (int p = m_dirty; p < m_cells; p++) {		//the layers up to the first changed cell still hold
+		const Layer& layer = m_layers[p];
+		Layer& next = m_layers[p + 1];
+		next.clear(next.size);
+		for (size_t i = 0; i < layer.state.size(); i++) {
+			if (layer.forward[i] == 0)
+				continue;
+			int n = moves(p, layer.state[i], mv);
+			for (int j = 0; j < n; j++)
+				if (canFinish(p + 1, mv[j].next))
+					next.add(mv[j].next, layer.forward[i]);
+			if (next.size > maxStates) {		//resumes from this layer next time
+				m_dirty = p;
+				m_tooBig = next.size;
+				return false;
+			}
+		}
+	}
+
+	Layer& last = m_layers[m_cells];			//only the state with every ship placed is finished
+	for (size_t i = 0; i < last.state.size(); i++)
+		last.backward[i] = (last.forward[i] != 0 ? 1 : 0);
+	fill(m_weight.begin(), m_weight.end(), 0);
+	for (int p = m_cells - 1; p >= 0; p--) {	//counts the ways to finish, and the layouts through each placement
+		Layer& layer = m_layers[p];
+		const Layer& next = m_layers[p + 1];
+		for (size_t i = 0; i < layer.state.size(); i++) {
+			if (layer.forward[i] == 0)
+				continue;
+			uint64_t ways = 0;
+			int n = moves(p, layer.state[i], mv);
+			for (int j = 0; j < n; j++) {
+				size_t slot = next.find(mv[j].next);
+				if (slot == next.state.size())
+					continue;
+				ways += next.backward[slot];
+				if (mv[j].placement >= 0)
+					m_weight[mv[j].placement] += layer.forward[i] * next.backward[slot];
+			}
+			layer.backward[i] = ways;
+		}
+	}
+	size_t start = m_layers[0].find(0);
+	m_total = (start == m_layers[0].state.size() ? 0 : m_layers[0].backward[start]) * m_kindLayouts;
+
+	m_occupancy.fill(0);
+	for (size_t idx = 0; idx < m_weight.size(); idx++) {
+		if (m_weight[idx] == 0)
+			continue;
+		int cell = int(idx % m_cells);
+		int g = int(idx / m_cells) / 2;
+		Direction dir = Direction(int(idx / m_cells) % 2);
+		int r = cell / m_cols, c = cell % m_cols;
+		for (int i = 0; i < m_kinds[g].length; i++)
+			m_occupancy(dir == HORIZONTAL ? r : r + i, dir == HORIZONTAL ? c + i : c) += m_weight[idx] * m_kindLayouts;
+	}
+	m_dirty = m_cells;
+	return true;
+}
@@ -0,0 +1,111 @@
+#ifndef LAYOUTCOUNTER_INCLUDED
+#define LAYOUTCOUNTER_INCLUDED
+
+#include "Grid.h"
+#include "globals.h"
+#include <cstdint>
+#include <vector>
+
+// Counts exactly how many layouts of the enemy fleet agree with the shots
+// fired so far, and how many of them put a ship on each cell.  A layout
+// agrees if no ship covers a miss, every hit is covered, each sunk ship
+// lies wholly on hits through the shot that sank it, and no ship afloat
+// lies wholly on hits.
+//
+// The count is a dynamic program over the cells in row-major order.  A
+// ship is placed whole at its top or left cell, so the state at a cell is
+// how many ships of each kind are placed so far and which of the next cells
+// they already cover.  Ships afloat of the same length are one kind,
+// counted together, and each sunk ship is a kind of its own.  A pass from
+// the top counts the ways to reach each state and a pass from the bottom
+// the ways to finish from it; their products give the layouts through each
+// placement.  The top-down layers are kept between calls, and only the
+// layers from the first cell whose placements a shot changed are
+// recounted.
+class LayoutCounter
+{
+public:
+	LayoutCounter() : m_rows(0), m_cols(0), m_cells(0), m_fleetLength(0), m_kindLayouts(1), m_dirty(0),
+		m_tooBig(0), m_total(0) {}
+
+	// Starts counting for a new game, or returns false if the board or the
+	// fleet is too big to count exactly: more than 100 cells, more than 8
+	// ships, or vertical ships longer than the state can look ahead
+	bool setGame(int rows, int cols, const std::vector<int>& lengths);
+	// Starts counting for another game of the same board and fleet.  The
+	// tables are freed, since they can take tens of megabytes.
+	void reset();
+
+	void recordShot(Point p, bool hit);
+	void recordSunk(Point p, int shipId);
+
+	// Recounts after the shots recorded since the last call.  Early in a
+	// game the states can number in the hundreds of thousands per cell, so
+	// this gives up, returning false, as soon as a cell has more than
+	// maxStates; the layers counted so far are kept for the next call, which
+	// gives up at once if no shot since has changed the layer that was too
+	// big.  By the time 2000 states suffice, on a 10x10 board with the
+	// standard fleet, a count takes a few milliseconds and the tables a few
+	// megabytes.
+	bool update(size_t maxStates = 2000);
+
+	// The number of layouts that agree with the shots, and the number of
+	// them with a ship on (r, c), as of the last successful update
+	uint64_t total() const { return m_total; }
+	uint64_t occupancy(int r, int c) const { return m_occupancy(r, c); }
+
+private:
+	enum { MASKSHIFT = 56 };		//a state is the ships placed above bit 56 and the covered cells below
+	struct Move {
+		uint64_t next;				//the state at the following cell
+		int placement;				//index into m_valid, or -1 if no ship starts here
+	};
+	// The states reachable at one cell, in an open-addressed table, with
+	// the ways to reach each from the first cell and to finish from it.
+	// A slot with no ways to reach it is empty.
+	struct Layer {
+		std::vector<uint64_t> state, forward, backward;
+		size_t size;
+		void clear(size_t capacity);
+		void add(uint64_t s, uint64_t ways);
+		size_t find(uint64_t s) const;			//the state's slot, or state.size() if absent
+	};
+	// Ships that are interchangeable in a layout: the ships afloat of one
+	// length, or one sunk ship.  A state holds how many are placed in a
+	// bit field of its own.
+	struct Kind {
+		int length;
+		int ships;
+		int sunkAt;					//the cell of the shot that sank it, or -1 if afloat
+		int shift, width;			//the field's lowest bit, counted from MASKSHIFT, and its bits
+	};
+	int m_rows, m_cols, m_cells;
+	std::vector<int> m_lengths;
+	Grid<char> m_board;				//'.' unknown, 'o' miss, 'X' hit
+	std::vector<int> m_sunkAt;		//indexed by ship ID: the cell of the shot that sank it, or -1
+	std::vector<Kind> m_kinds;
+	// Whether a ship of each kind fits at each cell in each direction,
+	// indexed by (kind * 2 + direction) * cells + cell, as of this count and
+	// the last one, and the cells it covers as bits of a state
+	std::vector<char> m_valid, m_wasValid;
+	std::vector<uint64_t> m_shape;
+	std::vector<Layer> m_layers;	//indexed by cell; the last is past the end of the board
+	std::vector<int> m_lastStart;	//indexed by kind: the last cell where one fits, or -1
+	int m_fleetLength;
+	uint64_t m_kindLayouts;			//layouts of the fleet for each layout of kinds, from swapping ships of a kind
+	std::vector<uint64_t> m_weight;	//layouts using each placement
+	std::vector<Move> m_moves;		//scratch for update
+	Grid<uint64_t> m_occupancy;
+	int m_dirty;					//the first cell whose moves changed since the last count
+	size_t m_tooBig;				//if the last update gave up, the states it had found in the layer after m_dirty, else 0
+	uint64_t m_total;
+
+	void setKinds();
+	void setValidity();
+	bool placementFits(int kind, Direction dir, int cell) const;
+	int moves(int cell, uint64_t state, Move* out) const;
+	bool canFinish(int cell, uint64_t state) const;
+	void markDirty(int cell);
+};
+
+#endif // LAYOUTCOUNTER_INCLUDED
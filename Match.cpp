@@ -0,0 +1,282 @@
+#include "Match.h"
+#include "Game.h"
+#include "Board.h"
+#include "Player.h"
+#include "Players.h"
+#include "PlayLoop.h"
+#include "globals.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+	const long long CHUNK = 16;		//games a worker takes from its own queue at a time
+
+	// The games a worker has yet to play, [next, end).  The owner takes
+	// games from the front; thieves take the back half.
+	struct WorkQueue {
+		mutex m;
+		long long next, end;
+	};
+
+	// Counts the shots each player fires, and times each move into
+	// moveTime[player] if moveTime is not null
+	class ShotCounter : public NullObserver
+	{
+	public:
+		ShotCounter(const Player* first, LatencyHistogram* moveTime) : m_first(first), m_moveTime(moveTime)
+		{
+			shots[0] = shots[1] = 0;
+		}
+		template <typename A, typename D, typename B>
+		void turnStarted(const A&, const D&, const B&)
+		{
+			if (m_moveTime != nullptr)
+				m_start = chrono::steady_clock::now();
+		}
+		template <typename A, typename D, typename B>
+		void shotFired(const A& attacker, const D&, const B&, Point, bool, bool, bool, int)
+		{
+			int i = (static_cast<const Player*>(&attacker) == m_first ? 0 : 1);
+			shots[i]++;
+			if (m_moveTime != nullptr)
+				m_moveTime[i].add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - m_start).count());
+		}
+		long long shots[2];
+	private:
+		const Player* m_first;
+		LatencyHistogram* m_moveTime;
+		chrono::steady_clock::time_point m_start;
+	};
+
+	void recordGame(Player* winner, const Player* p1, const ShotCounter& counter, MatchResult& result)
+	{
+		if (winner == nullptr) {
+			result.failures++;
+			return;
+		}
+		int w = (winner == p1 ? 0 : 1);
+		result.wins[w]++;
+		vector<long long>& hist = result.shotsToWin[w];
+		if (hist.size() <= size_t(counter.shots[w]))
+			hist.resize(counter.shots[w] + 1, 0);
+		hist[counter.shots[w]]++;
+	}
+
+	// Plays games first through last - 1 between p1 and p2, resetting them
+	// for each game.  A player's seed is drawn from the game just as when
+	// it is created, so the results match creating new players every game.
+	template <typename P1, typename P2>
+	void playGames(const MatchConfig& config, Game& g, P1& p1, P2& p2, Board& b1, Board& b2,
+		long long first, long long last, MatchResult& result)
+	{
+		for (long long k = first; k < last; k++) {
+			g.seed(mixSeed(config.seed, k));
+			p1.reset(g.rng().next());
+			p2.reset(g.rng().next());
+			ShotCounter counter(&p1, config.timeMoves ? result.moveTime : nullptr);
+			Player* winner = (k % 2 == 0 ? playGame(p1, p2, b1, b2, counter) : playGame(p2, p1, b1, b2, counter));
+			recordGame(winner, &p1, counter, result);
+		}
+	}
+
+	typedef void (*Worker)(const MatchConfig&, vector<WorkQueue>&, size_t, MatchResult&);
+
+	bool addFleet(Game& g, const vector<ShipSpec>& fleet)
+	{
+		for (size_t i = 0; i < fleet.size(); i++)
+			if (!g.addShip(fleet[i].length, fleet[i].symbol, fleet[i].name))
+				return false;
+		return !fleet.empty();
+	}
+
+	void clearResult(MatchResult& result)
+	{
+		result.wins[0] = result.wins[1] = 0;
+		result.failures = 0;
+		result.shotsToWin[0].clear();
+		result.shotsToWin[1].clear();
+		result.moveTime[0].clear();
+		result.moveTime[1].clear();
+		result.seconds = 0;
+	}
+
+	// Takes up to CHUNK games from the front of q
+	bool takeWork(WorkQueue& q, long long& first, long long& last)
+	{
+		lock_guard<mutex> lock(q.m);
+		if (q.next >= q.end)
+			return false;
+		first = q.next;
+		last = min(q.end, q.next + CHUNK);
+		q.next = last;
+		return true;
+	}
+
+	// Moves the back half of some other queue's games into queues[self]
+	bool stealWork(vector<WorkQueue>& queues, size_t self)
+	{
+		for (size_t k = 1; k < queues.size(); k++) {
+			WorkQueue& victim = queues[(self + k) % queues.size()];
+			long long first, last;
+			{
+				lock_guard<mutex> lock(victim.m);
+				long long left = victim.end - victim.next;
+				if (left <= 0)
+					continue;
+				first = victim.end - (left + 1) / 2;
+				last = victim.end;
+				victim.end = first;
+			}
+			lock_guard<mutex> lock(queues[self].m);
+			queues[self].next = first;
+			queues[self].end = last;
+			return true;
+		}
+		return false;
+	}
+
+	// Takes games from queues[self], or steals them when it runs out, and
+	// plays them with play until none are left
+	template <typename PlayRange>
+	void drainQueues(vector<WorkQueue>& queues, size_t self, PlayRange play)
+	{
+		for (;;) {
+			long long first, last;
+			if (!takeWork(queues[self], first, last)) {
+				if (!stealWork(queues, self))
+					return;
+				continue;
+			}
+			play(first, last);
+		}
+	}
+
+	// A worker for players of the concrete types P1 and P2, so that the
+	// whole turn loop is compiled for them.  It owns its game, boards and
+	// players and reuses them for every game it plays.
+	template <typename P1, typename P2>
+	void worker(const MatchConfig& config, vector<WorkQueue>& queues, size_t self, MatchResult& result)
+	{
+		Game g(config.rows, config.cols);
+		addFleet(g, config.fleet);
+		Board b1(g), b2(g);
+		P1 p1("Player 1", g);
+		P2 p2("Player 2", g);
+		drainQueues(queues, self, [&](long long first, long long last) {
+			playGames(config, g, p1, p2, b1, b2, first, last, result);
+		});
+	}
+
+	// The same for player types known only by name, through createPlayer
+	void workerByName(const MatchConfig& config, vector<WorkQueue>& queues, size_t self, MatchResult& result)
+	{
+		Game g(config.rows, config.cols);
+		addFleet(g, config.fleet);
+		Board b1(g), b2(g);
+		Player* p1 = createPlayer(config.player1, "Player 1", g);
+		Player* p2 = createPlayer(config.player2, "Player 2", g);
+		drainQueues(queues, self, [&](long long first, long long last) {
+			playGames(config, g, *p1, *p2, b1, b2, first, last, result);
+		});
+		delete p1;
+		delete p2;
+	}
+
+	template <typename P1>
+	Worker workerFor(const string& type2)
+	{
+		if (type2 == "awful")
+			return worker<P1, AwfulPlayer>;
+		if (type2 == "mediocre")
+			return worker<P1, MediocrePlayer>;
+		if (type2 == "good")
+			return worker<P1, GoodPlayer>;
+		if (type2 == "montecarlo")
+			return worker<P1, MonteCarloPlayer>;
+		if (type2 == "exact")
+			return worker<P1, ExactPlayer>;
+		return workerByName;
+	}
+
+	// Returns the worker compiled for the matchup, or workerByName for
+	// player types it does not know
+	Worker workerFor(const string& type1, const string& type2)
+	{
+		if (type1 == "awful")
+			return workerFor<AwfulPlayer>(type2);
+		if (type1 == "mediocre")
+			return workerFor<MediocrePlayer>(type2);
+		if (type1 == "good")
+			return workerFor<GoodPlayer>(type2);
+		if (type1 == "montecarlo")
+			return workerFor<MonteCarloPlayer>(type2);
+		if (type1 == "exact")
+			return workerFor<ExactPlayer>(type2);
+		return workerByName;
+	}
+}
+
+bool runMatch(const MatchConfig& config, MatchResult& result)
+{
+	clearResult(result);
+	if (config.rows < 1 || config.rows > MAXROWS || config.cols < 1 || config.cols > MAXCOLS)
+		return false;
+	{
+		Game g(config.rows, config.cols);			//checks the configuration before starting any threads
+		if (!addFleet(g, config.fleet))
+			return false;
+		Player* p1 = createPlayer(config.player1, "Player 1", g);
+		Player* p2 = createPlayer(config.player2, "Player 2", g);
+		bool ok = (p1 != nullptr && p2 != nullptr && !p1->isHuman() && !p2->isHuman());
+		delete p1;
+		delete p2;
+		if (!ok)
+			return false;
+	}
+
+	int nThreads = config.nThreads;
+	if (nThreads <= 0)
+		nThreads = max(1, int(thread::hardware_concurrency()));
+	if (nThreads > config.nGames)
+		nThreads = int(max(1LL, config.nGames));
+
+	vector<WorkQueue> queues(nThreads);			//splits the games evenly to begin with
+	for (int t = 0; t < nThreads; t++) {
+		queues[t].next = config.nGames * t / nThreads;
+		queues[t].end = config.nGames * (t + 1) / nThreads;
+	}
+
+	vector<MatchResult> partial(nThreads);
+	for (int t = 0; t < nThreads; t++)
+		clearResult(partial[t]);
+
+	Worker work = workerFor(config.player1, config.player2);
+	auto start = chrono::steady_clock::now();
+	vector<thread> threads;
+	for (int t = 1; t < nThreads; t++)
+		threads.push_back(thread(work, cref(config), ref(queues), size_t(t), ref(partial[t])));
+	work(config, queues, 0, partial[0]);			//the calling thread works too
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	for (int t = 0; t < nThreads; t++) {			//combines the workers' results
+		for (int w = 0; w < 2; w++) {
+			result.wins[w] += partial[t].wins[w];
+			vector<long long>& hist = result.shotsToWin[w];
+			const vector<long long>& part = partial[t].shotsToWin[w];
+			if (hist.size() < part.size())
+				hist.resize(part.size(), 0);
+			for (size_t n = 0; n < part.size(); n++)
+				hist[n] += part[n];
+			result.moveTime[w].merge(partial[t].moveTime[w]);
+		}
+		result.failures += partial[t].failures;
+	}
+	return true;
+}
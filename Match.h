@@ -0,0 +1,53 @@
+#ifndef MATCH_INCLUDED
+#define MATCH_INCLUDED
+
+#include "Histogram.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ShipSpec
+{
+	int length;
+	char symbol;
+	std::string name;
+};
+
+struct MatchConfig
+{
+	MatchConfig() : rows(10), cols(10), nGames(100), nThreads(0), seed(0), timeMoves(false) {}
+	int rows, cols;
+	std::vector<ShipSpec> fleet;
+	std::string player1, player2;	// createPlayer type names
+	long long nGames;
+	int nThreads;					// 0 means one per hardware thread
+	uint64_t seed;					// game k is seeded with mixSeed(seed, k)
+	bool timeMoves;					// fill in MatchResult::moveTime, reading the clock twice a move
+};
+
+struct MatchResult
+{
+	long long wins[2];				// games won by player1 and player2
+	long long failures;				// games where a player could not place its ships
+	// shotsToWin[i][n] is the number of games player i+1 won firing n shots
+	std::vector<long long> shotsToWin[2];
+	// If config.timeMoves, the nanoseconds each of player i+1's moves took,
+	// from the start of its turn through its shot, the board's answer and
+	// both players recording it
+	LatencyHistogram moveTime[2];
+	double seconds;
+};
+
+// Plays config.nGames games between the two player types, spreading them
+// over config.nThreads threads.  player1 moves first in even-numbered games
+// and player2 in odd-numbered ones.  Each game and its players are seeded
+// from the game's number, so a match's results do not depend on the
+// number of threads, except with montecarlo players and the exact players
+// that fall back on their sampling: how many layouts they sample in their
+// 20 ms per move depends on the machine and its load, so their moves, and
+// the results, can differ from run to run.  Returns
+// false without playing if the fleet or a player type is invalid or a
+// player type is human.
+bool runMatch(const MatchConfig& config, MatchResult& result);
+
+#endif // MATCH_INCLUDED
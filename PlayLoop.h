@@ -0,0 +1,84 @@
+#ifndef PLAYLOOP_INCLUDED
+#define PLAYLOOP_INCLUDED
+
+#include "Player.h"
+#include "Profile.h"
+#include "globals.h"
+
+// The turn loop of a game, written as templates over the two players', the
+// boards' and the observer's types.  GameImpl::play instantiates it with
+// Player, Board and GameObserver, so every call goes through the vtable as
+// before; a simulation that knows its matchup instantiates it with the
+// final classes in Players.h and an observer like NullObserver, and the
+// compiler can then call and inline each player's functions directly.
+// (The player functions are defined in Player.cpp, so inlining them into
+// another source file also takes link-time optimization, e.g. -flto.)
+// Building with BATTLESHIP_PROFILE times the players' calls (Profile.h).
+
+// An observer that ignores every event.  Its functions are empty inline
+// templates, so the calls to them compile to nothing; derive from it and
+// hide just the functions you need.
+struct NullObserver
+{
+	template <typename P1, typename P2, typename B>
+	void gameStarted(const P1&, const P2&, const B&, const B&) {}
+	template <typename A, typename D, typename B>
+	void turnStarted(const A&, const D&, const B&) {}
+	template <typename A, typename D, typename B>
+	void shotFired(const A&, const D&, const B&, Point, bool, bool, bool, int) {}
+	template <typename A, typename D>
+	void shipSunk(const A&, const D&, int) {}
+	template <typename A, typename D>
+	void turnEnded(const A&, const D&) {}
+	template <typename W, typename L, typename B>
+	void gameOver(const W&, const L&, const B&, const B&) {}
+};
+
+// Plays one turn of attacker against the defender's board target, and
+// returns true if it sank the defender's last ship
+template <typename Attacker, typename Defender, typename BoardT, typename Observer>
+inline bool playTurn(Attacker& attacker, Defender& defender, BoardT& target, BoardT& own, Observer& obs)
+{
+	obs.turnStarted(attacker, defender, target);
+
+	Point p;
+	PROFILE_CALL(attacker, PROFILE_RECOMMEND, p = attacker.recommendAttack());	//attacker recommends attack
+	bool hit, destroy;
+	int id;
+	bool gate = target.attack(p, hit, destroy, id);		//defender's board reflects target coordinate
+	PROFILE_CALL(attacker, PROFILE_RECORD, attacker.recordAttackResult(p, gate, hit, destroy, id));	//attacker records result of attack
+	defender.recordAttackByOpponent(p);					//defender records opponents atack
+
+	obs.shotFired(attacker, defender, target, p, gate, hit, destroy, id);
+	if (gate && destroy)
+		obs.shipSunk(attacker, defender, id);
+
+	if (target.allShipsDestroyed()) {		//if all of the defender's ships are destroyed, attacker won
+		obs.gameOver(attacker, defender, own, target);
+		return true;
+	}
+	obs.turnEnded(attacker, defender);
+	return false;
+}
+
+// Clears the boards, has p1 and p2 place their ships on b1 and b2, and
+// plays turns, p1 first, until one of them wins.  Returns the winner, or
+// nullptr if either player could not place its ships.
+template <typename P1, typename P2, typename BoardT, typename Observer>
+Player* playGame(P1& p1, P2& p2, BoardT& b1, BoardT& b2, Observer& obs)
+{
+	b1.clear();
+	b2.clear();
+	if (!p1.placeShips(b1) || !p2.placeShips(b2))
+		return nullptr;
+	obs.gameStarted(p1, p2, b1, b2);
+
+	for (;;) {			//the players take turns, which needs no swap when their types differ
+		if (playTurn(p1, p2, b2, b1, obs))
+			return &p1;
+		if (playTurn(p2, p1, b1, b2, obs))
+			return &p2;
+	}
+}
+
+#endif // PLAYLOOP_INCLUDED
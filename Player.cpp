@@ -1,32 +1,62 @@
 #include "Player.h"
+#include "Players.h"
 #include "Board.h"
 #include "Game.h"
 #include "globals.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <chrono>
 
 using namespace std;
 
+Player::Player(string nm, const Game& g) : m_name(nm), m_game(g), m_rng(g.rng().next())
+{}
+
+Fleet::Fleet(const Game& g) : lengths(g.nShips()), layout(g.nShips())
+{
+	for (int k = 0; k < g.nShips(); k++)
+		lengths[k] = g.shipLength(k);
+	fits = fleetFits(g.rows(), g.cols(), lengths);
+}
+
+// Places the fleet on b at random, drawing uniformly when that succeeds
+// quickly, and sets fleet.layout to where the ships went.  Returns false,
+// printing nothing, if no layout was found; the caller reports the failure.
+bool placeFleetRandomly(Board& b, const Game& g, Fleet& fleet, FleetPlacer& placer, Rng& rng)
+{
+	if (!fleet.fits)
+		return false;
+
+	vector<ShipPlacement>& layout = fleet.layout;
+	placer.setBoard(g.rows(), g.cols());
+	FleetPlacer::Result result = placer.placeUniform(fleet.lengths, rng, layout, 100);
+	if (result == FleetPlacer::GAVE_UP)		//crowded fleets rarely draw without overlap
+		result = placer.place(fleet.lengths, rng, layout);
+	if (result != FleetPlacer::PLACED)
+		return false;
+
+	for (int k = 0; k < g.nShips(); k++)
+		if (!b.placeShip(layout[k].topOrLeft, k, layout[k].dir))
+			return false;
+	return true;
+}
+
 //*********************************************************************
 //  AwfulPlayer
 //*********************************************************************
 
-class AwfulPlayer : public Player
-{
-public:
-	AwfulPlayer(string nm, const Game& g);
-	virtual bool placeShips(Board& b);
-	virtual Point recommendAttack();
-	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
-	virtual void recordAttackByOpponent(Point p);
-private:
-	Point m_lastCellAttacked;
-};
-
 AwfulPlayer::AwfulPlayer(string nm, const Game& g) : Player(nm, g), m_lastCellAttacked(0, 0)
 {}
 
+void AwfulPlayer::reset(uint64_t s)
+{
+	Player::reset(s);
+	m_lastCellAttacked = Point(0, 0);
+}
+
 bool AwfulPlayer::placeShips(Board& b)
 {
 	// Clustering ships is bad strategy
@@ -76,18 +106,6 @@ bool getLineWithTwoIntegers(int& r, int& c)
 	return result;
 }
 
-
-class HumanPlayer : public Player
-{
-public:
-	HumanPlayer(string nm, const Game& g);
-	virtual bool placeShips(Board& b);
-	virtual Point recommendAttack();
-	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
-	virtual void recordAttackByOpponent(Point p);
-	virtual bool isHuman() const { return true; }
-};
-
 HumanPlayer::HumanPlayer(string nm, const Game& g) : Player(nm, g) {}
 
 bool HumanPlayer::placeShips(Board& b) {
@@ -163,70 +181,38 @@ void HumanPlayer::recordAttackByOpponent(Point /* p */)
 	// AwfulPlayer completely ignores what the opponent does
 }
 
-
 //*********************************************************************
 //  MediocrePlayer
 //*********************************************************************
 
-class MediocrePlayer : public Player {
-public:
-	MediocrePlayer(string nm, const Game& g);
-	virtual bool placeShips(Board& b);
-	virtual Point recommendAttack();
-	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
-	virtual void recordAttackByOpponent(Point p);
-	bool placeRec(Board & b, int r = 0, int c = 0, int k = 0);
-private:
-	char cellsAttacked[MAXROWS][MAXCOLS];
-	Point lastAttacked;
-	int state;
-};
 // Remember that Mediocre::placeShips(Board& b) must start by calling
 // b.block(), and must call b.unblock() just before returning.
 
-MediocrePlayer::MediocrePlayer(string nm, const Game& g) : lastAttacked(-1, -1), Player(nm, g) {
+MediocrePlayer::MediocrePlayer(string nm, const Game& g)
+	: Player(nm, g), unattacked(g.rows(), g.cols()), m_fleet(g), lastAttacked(-1, -1) {	//initially no cell has been attacked
 	state = 1;													//begin in state 1
-
-	for (int r = 0; r < game().rows(); r++)						//initialize attacked cells to empty
-		for (int c = 0; c < game().cols(); c++)
-			cellsAttacked[r][c] = '.';
-
 }
 
-bool MediocrePlayer::placeRec(Board & b, int r, int c, int k) {
-	if (k == game().nShips())										//if all ships are on board return true
-		return true;
-
-	if (r == game().rows() && c == game().cols())					//case if its not possible for all ships to fit on board
-		return false;
-
-	if (b.placeShip(Point(r, c), k, HORIZONTAL))					//attempt to place ship horizontally
-		if (placeRec(b, 0, 0, k + 1)) {
-			return true;
-		}
-		else (b.unplaceShip(Point(r, c), k, HORIZONTAL));			//if this causes the next ships to be unplaceable, undo its placement
-
-
-		if (b.placeShip(Point(r, c), k, VERTICAL))						//same process as above but for vertical placement
-			if (placeRec(b, 0, 0, k + 1)) {
-				return true;
-			}
-			else (b.unplaceShip(Point(r, c), k, VERTICAL));
-
-
-			if (r < game().rows())									//if the ship did not fit in this point, move down one row
-				return placeRec(b, r + 1, c, k);
-
-			r = 0;													//if we are at the last row, move over to top of next column
-			return placeRec(b, r, c + 1, k);
-
-			return false;
+void MediocrePlayer::reset(uint64_t s) {
+	Player::reset(s);
+	unattacked.reset(game().rows(), game().cols());
+	lastAttacked = Point(-1, -1);
+	state = 1;
 }
 
 bool MediocrePlayer::placeShips(Board & b) {
+	if (!m_fleet.fits)		//no blocking could leave room for the ships
+		return false;
+
+	vector<ShipPlacement>& layout = m_fleet.layout;
 	for (int i = 0; i < 50; i++) {			//attempts to place ships 50 times
 		b.block();							//blocks board
-		if (placeRec(b)) {					//calls recursive function
+		b.takenCells(m_taken);
+		m_placer.setBoard(game().rows(), game().cols());
+		m_placer.setTaken(m_taken);
+		if (m_placer.solve(m_fleet.lengths, layout, 100000) == FleetPlacer::PLACED) {		//searches the free cells for a layout
+			for (int k = 0; k < game().nShips(); k++)
+				b.placeShip(layout[k].topOrLeft, k, layout[k].dir);
 			b.unblock();					//unblocks board
 			return true;
 		}
@@ -251,77 +237,35 @@ Point MediocrePlayer::recommendAttack() {
 		if (leastr < 0)
 			leastr = 0;
 		int greatr = r + 4;
-		if (greatr > rows)
-			greatr = rows;
+		if (greatr >= rows)						//keeps the range on the board
+			greatr = rows - 1;
 
 		int leastc = c - 4;
 		if (leastc < 0)
 			leastc = 0;
 		int greatc = c + 4;
-		if (greatc > cols)
-			greatc = cols;
-
-		int ranger = greatr - leastr;
-		int rangec = greatc - leastc;
-		int max = greatr;
-		if (max == rows)
-			max--;
-		state = 1;
-		for (int i = leastr; i <= max; i++)			//returns to state 1 if all nearby cells have been attacked already
-			if (cellsAttacked[i][c] == '.') {
-				state = 2;
-				break;
-			}
-			
-		max = greatc;
-		if (max == cols)
-			max--;
-		if (state == 1)
-			for (int i = leastc; i <= max; i++)
-				if (cellsAttacked[r][i] == '.') {
-					state = 2;
-					break;
-				}
-				
-
-				if (state == 2) {
-					for (;;) {				//infinite loop
-
-						int gate = randInt(2);				//random number decides to attack horizontaly or vertically
-						if (gate == 1) {					// generate random row point to attack within range
-							r = randInt(ranger + 1);
-							r = leastr + r;
-						}
-						else {
-							c = randInt(rangec + 1);		//generate random column point to attack within range
-							c = leastc + c;
-						}
-
-						if (cellsAttacked[r][c] == '.') {
-							cellsAttacked[r][c] = '*';				//if the point has not been attacked, mark it and attack it
-							return Point(r, c);
-						}
-						else {							//otherwise repeat the process
-							r = lastAttacked.r;
-							c = lastAttacked.c;
-						}
-					}
-				}
-
-	}
-
-	if (state == 1) {
-		for (;;) {
-			int r = randInt(rows);				//attacks random point on the board
-			int c = randInt(cols);
-			if (cellsAttacked[r][c] == '.') {
-				cellsAttacked[r][c] = '*';
-				return Point(r, c);
-			}
+		if (greatc >= cols)
+			greatc = cols - 1;
+
+		Point p;
+		bool found;
+		if (rng().nextInt(2) == 1)				//random number decides to attack vertically or horizontally first
+			found = unattacked.sampleInCol(c, leastr, greatr, rng(), p) || unattacked.sampleInRow(r, leastc, greatc, rng(), p);
+		else found = unattacked.sampleInRow(r, leastc, greatc, rng(), p) || unattacked.sampleInCol(c, leastr, greatr, rng(), p);
+
+		if (found) {
+			unattacked.remove(p.r, p.c);		//if a nearby point has not been attacked, mark it and attack it
+			return p;
 		}
+		state = 1;								//returns to state 1 if all nearby cells have been attacked already
 	}
 
-	return Point(0, 0);
+	if (unattacked.size() == 0)					//every cell has been attacked
+		return Point(0, 0);
+
+	Point p = unattacked.sample(rng());			//attacks random point on the board
+	unattacked.remove(p.r, p.c);
+	return p;
 }
 
 void MediocrePlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId) {
@@ -352,80 +296,6 @@ void MediocrePlayer::recordAttackResult(Point p, bool validShot, bool shotHit, b
 //  GoodPlayer
 //*********************************************************************
 
-class GoodPlayer : public Player {
-public:
-	GoodPlayer(string name, const Game& g);
-	virtual bool placeShips(Board& b);
-	virtual Point recommendAttack();
-	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
-	virtual void recordAttackByOpponent(Point p);
-	~GoodPlayer();
-	Point findSpot();
-	bool placeRec(Board& b, int counter, int k = 0, int r = 0, int c = 0);
-	bool checkFit(Point p, int length, Direction dir);
-private:
-	char attackedCells[MAXROWS][MAXCOLS];
-	int m_state, nShots, oppShots, target, totalHealth, currentHealth;
-	struct Node {
-		int shipId;
-		bool shipDestroyed;
-		vector<Point> pos;
-		Node* next;
-	};
-	Node* head;
-	char m_grid[MAXROWS][MAXCOLS];
-	struct myShips {
-		int Id, health;
-		bool destroyed;
-		char symbol;
-		myShips* next;
-	};
-	myShips* headptr;
-	struct shipsRemaining {
-		int ID, length;
-		shipsRemaining* next;
-		bool destroyed;
-	};
-	shipsRemaining* shipPTR;
-	int densityGrid[MAXROWS][MAXCOLS];
-};
-
-bool GoodPlayer::placeRec(Board & b, int counter, int k, int r, int c) {			//same process as mediocre player
-	if (k == game().nShips())
-		return true;
-	counter++;
-
-	if (counter > 1000)
-		return false;
-
-	r = randInt(game().rows());
-	c = randInt(game().cols());
-
-	int randDir = randInt(2);				//chooses to place ships randomly
-	if (randDir == 0) {
-		if (b.placeShip(Point(r, c), k, HORIZONTAL))
-			if (placeRec(b, counter, k + 1)) {
-				for (int i = 0; i < game().shipLength(k); i++) {			//records the placed ship location on its private grid
-					m_grid[r][c + i] = game().shipSymbol(k);
-				}
-				return true;
-			}
-			else (b.unplaceShip(Point(r, c), k, HORIZONTAL));		//remove ship if it prevents other from fitting
-	}
-	else {
-		if (b.placeShip(Point(r, c), k, VERTICAL))			//same process for vertical direction
-			if (placeRec(b, counter, k + 1)) {
-				return true;
-				for (int i = 0; i < game().shipLength(k); i++) {
-					m_grid[r + i][c] = game().shipSymbol(k);
-				}
-			}
-			else (b.unplaceShip(Point(r, c), k, VERTICAL));
-	}
-
-	return placeRec(b, counter, k);		//repeat process until all ships placed
-}
-
 bool GoodPlayer::checkFit(Point p, int length, Direction dir) {
 	int r = p.r;
 	int c = p.c;
@@ -437,70 +307,82 @@ bool GoodPlayer::checkFit(Point p, int length, Direction dir) {
 
 	if (dir == HORIZONTAL) {							//checks each point that the ship would occupy if placed at a given location and returns false if any point is not a dot
 		for (int i = 0; i < length; i++)
-			if (attackedCells[r][c + i] != '.')
+			if (attackedCells(r, c + i) != '.')
 				return false;
 	}
 
 	else if (dir == VERTICAL) {
 		for (int i = 0; i < length; i++)
-			if (attackedCells[r + i][c] != '.')
+			if (attackedCells(r + i, c) != '.')
 				return false;
 	}
 
 	return true;
 }
 
+void GoodPlayer::addShipDensity(int length, int weight) {
+	m_kernel.setCells(attackedCells, '.');			//changes the value of each point where a ship could be
+	m_kernel.add(length, weight, densityGrid);
+}
+
+bool GoodPlayer::isUnattacked(int r, int c) const {
+	return r >= 0 && c >= 0 && r < game().rows() && c < game().cols() && attackedCells(r, c) == '.';
+}
+
+void GoodPlayer::markAttacked(int r, int c) {
+	if (attackedCells(r, c) != '.')
+		return;
+
+	for (size_t k = 0; k < shipsLeft.size(); k++) { //removes the placements of each remaining ship that cross this cell
+		if (shipsLeft[k].destroyed)
+			continue;
+		int length = shipsLeft[k].length;
+		for (int startc = max(0, c - length + 1); startc <= c; startc++) {
+			if (checkFit(Point(r, startc), length, HORIZONTAL))
+				for (int i = 0; i < length; i++)
+					densityGrid(r, startc + i)--;
+		}
+		for (int startr = max(0, r - length + 1); startr <= r; startr++) {
+			if (checkFit(Point(startr, c), length, VERTICAL))
+				for (int i = 0; i < length; i++)
+					densityGrid(startr + i, c)--;
+		}
+	}
+
+	attackedCells(r, c) = '*';
+	m_unattacked.remove(r, c);
+}
+
 Point GoodPlayer::findSpot() {
-	int r, c;
 	int rows = game().rows();
 	int cols = game().cols();
 	//if (m_state == 1 && (1.0 * nShots / (rows * cols) >= .5))	//if in state 1 and half the board has been attacked, switch to state 3
 		//m_state = 3;
 
-	if (m_state == 1) {
-		for (int i = 0; i < rows; i++)
-			for (int k = 0; k < cols; k++)
-				densityGrid[i][k] = 0;
-
-		for (shipsRemaining* ptr = shipPTR; ptr != nullptr; ptr = ptr->next) { //loops for each remaining ship
-			if (!ptr->destroyed) {
-				for (int i = 0; i < rows; i++)
-					for (int k = 0; k < cols; k++) {
-						if (checkFit(Point(i, k), ptr->length, HORIZONTAL)) {
-							for (int startc = 0; startc < ptr->length; startc++) { //increments the value of each point where a ship could be
-								densityGrid[i][k + startc]++;
-							}
-						}
-						if (checkFit(Point(i, k), ptr->length, VERTICAL)) {
-							for (int startr = 0; startr < ptr->length; startr++) {
-								densityGrid[i + startr][k]++;
-							}
-						}
-					}
-			}
-		}
-
+	if (m_state == 1) {		//densityGrid already holds the number of ways a remaining ship could cover each cell
 		int countUp = 0;
 		Point likely(0, 0);
 		for (int i = 0; i < rows; i++)
 			for (int k = 0; k < cols; k++) {
-				if (densityGrid[i][k] > countUp) {			//attacks the most likely position
-					countUp = densityGrid[i][k];
+				if (densityGrid(i, k) > countUp) {			//attacks the most likely position
+					countUp = densityGrid(i, k);
 					likely.r = i;
 					likely.c = k;
 				}
 			}
-		attackedCells[likely.r][likely.c] = '*';
+		markAttacked(likely.r, likely.c);
 		return likely;
 
 	}
 
 	if (m_state == 2) {
-		Node* ptr = head;
+		Node* ptr = nullptr;
 
-		for (; ptr != nullptr; ptr = ptr->next) {		//finds currently targeted ship
-			if (ptr->shipId == target)
+		for (int i = int(nodes.size()) - 1; i >= 0; i--) {		//finds currently targeted ship, newest first
+			if (nodes[i].shipId == target) {
+				ptr = &nodes[i];
 				break;
+			}
 		}
 
 		if (ptr == nullptr)
@@ -514,25 +396,26 @@ Point GoodPlayer::findSpot() {
 			if (r1 == r2) {				//if the ship is oriented horizontally
 				int cl = 0;
 				for (int i = 0; i < ptr->pos.size() && ptr->pos[i].c != -1; i++) { //find the most recently hit point
-					cl = ptr->pos[i].c;
+					if (ptr->pos[i].r >= 0 && ptr->pos[i].c >= 0)		//skips hits handed to another ship
+						cl = ptr->pos[i].c;
 				}
-				if (cl < cols - 1 && attackedCells[r1][cl + 1] == '.') {	//attack up over one column if it has not been attacked yet
-					attackedCells[r1][cl + 1] = '*';
+				if (isUnattacked(r1, cl + 1)) {	//attack up over one column if it has not been attacked yet
+					markAttacked(r1, cl + 1);
 					nShots++;
 					return Point(r1, cl + 1);
 				}
-				else if (cl > 0 && attackedCells[r1][cl - 1] == '.') {		//attack one column left if it has not been attacked
-					attackedCells[r1][cl - 1] = '*';
+				else if (isUnattacked(r1, cl - 1)) {		//attack one column left if it has not been attacked
+					markAttacked(r1, cl - 1);
 					nShots++;
 					return Point(r1, cl - 1);
 				}
-				else if (c1 < cols - 1 && attackedCells[r1][c1 + 1] == '.') { //attack one column right from first hit location
-					attackedCells[r1][c1 + 1] = '*';
+				else if (isUnattacked(r1, c1 + 1)) { //attack one column right from first hit location
+					markAttacked(r1, c1 + 1);
 					nShots++;
 					return Point(r1, c1 + 1);
 				}
-				else if (c1 > 0 && attackedCells[r1][c1 - 1] == '.') {		//attack one column left from first hit location
-					attackedCells[r1][c1 - 1] = '*';
+				else if (isUnattacked(r1, c1 - 1)) {		//attack one column left from first hit location
+					markAttacked(r1, c1 - 1);
 					nShots++;
 					return Point(r1, c1 - 1);
 				}
@@ -540,25 +423,26 @@ Point GoodPlayer::findSpot() {
 			if (c1 == c2) {						//same process for vertically placed ship
 				int rl = 0;
 				for (int i = 0; i < ptr->pos.size() && ptr->pos[i].r != -1; i++) {
-					rl = ptr->pos[i].r;
+					if (ptr->pos[i].r >= 0 && ptr->pos[i].c >= 0)
+						rl = ptr->pos[i].r;
 				}
-				if (rl < rows - 1 && attackedCells[rl + 1][c1] == '.') {
-					attackedCells[rl + 1][c1] = '*';
+				if (isUnattacked(rl + 1, c1)) {
+					markAttacked(rl + 1, c1);
 					nShots++;
 					return Point(rl + 1, c1);
 				}
-				else if (rl > 0 && attackedCells[rl - 1][c1] == '.') {
-					attackedCells[rl - 1][c1] = '*';
+				else if (isUnattacked(rl - 1, c1)) {
+					markAttacked(rl - 1, c1);
 					nShots++;
 					return Point(rl - 1, c1);
 				}
-				else if (r1 > 0 && attackedCells[r1 - 1][c1] == '.') {
-					attackedCells[r1 - 1][c1] = '*';
+				else if (isUnattacked(r1 - 1, c1)) {
+					markAttacked(r1 - 1, c1);
 					nShots++;
 					return Point(r1 - 1, c1);
 				}
-				else if (r1 < rows - 1 && attackedCells[r1 + 1][c1] == '.') {
-					attackedCells[r1 + 1][c1] = '*';
+				else if (isUnattacked(r1 + 1, c1)) {
+					markAttacked(r1 + 1, c1);
 					nShots++;
 					return Point(r1 + 1, c1);
 				}
@@ -566,13 +450,13 @@ Point GoodPlayer::findSpot() {
 		}
 
 		if (ptr->pos.size() >= 2) {		//if we reach this point, then our vector contains the location of multiple ships
-			Node* ptr1 = new Node;		//creates new node to contain second ship
-			ptr1->next = head;
+			size_t index = ptr - &nodes[0];
+			Node* ptr1 = &addNode();		//creates new node to contain second ship
+			ptr = &nodes[index];			//adding a node can move the others
 			ptr1->shipDestroyed = false;
 			ptr1->shipId = ptr->shipId + 1;
-			head = ptr1;
 
-			for (vector<Point>::iterator it = ptr->pos.begin() + 1; it != ptr->pos.end();) {
+			for (Points::iterator it = ptr->pos.begin() + 1; it != ptr->pos.end();) {
 				int newr = it->r;
 				int newc = it->c;
 				ptr1->pos.push_back(Point(newr, newc));		//creates new node's vector to contain location of second ship
@@ -580,43 +464,54 @@ Point GoodPlayer::findSpot() {
 			}
 		}
 
-		if (r1 > 0 && attackedCells[r1 - 1][c1] == '.') {		//attacks counterclockwise around the originally hit location
-			attackedCells[r1 - 1][c1] = '*';
+		if (isUnattacked(r1 - 1, c1)) {		//attacks counterclockwise around the originally hit location
+			markAttacked(r1 - 1, c1);
 			nShots++;
 			return Point(r1 - 1, c1);
 		}
-		else if (c1 > 0 && attackedCells[r1][c1 - 1] == '.') {
-			attackedCells[r1][c1 - 1] = '*';
+		else if (isUnattacked(r1, c1 - 1)) {
+			markAttacked(r1, c1 - 1);
 			nShots++;
 			return Point(r1, c1 - 1);
 		}
-		else if (r1 < rows - 1 && attackedCells[r1 + 1][c1] == '.') {
-			attackedCells[r1 + 1][c1] = '*';
+		else if (isUnattacked(r1 + 1, c1)) {
+			markAttacked(r1 + 1, c1);
 			nShots++;
 			return Point(r1 + 1, c1);
 		}
 
-		else if (c1 < cols - 1 && attackedCells[r1][c1 + 1] == '.') {
-			attackedCells[r1][c1 + 1] = '*';
+		else if (isUnattacked(r1, c1 + 1)) {
+			markAttacked(r1, c1 + 1);
 			nShots++;
 			return Point(r1, c1 + 1);
 		}
 	}
 
-	for (;;) {			//attacks randomly if in state 3
-		r = randInt(rows);
-		c = randInt(cols);
-		if (attackedCells[r][c] == '.') {
-			attackedCells[r][c] = '*';
-			nShots++;
-			return Point(r, c);
-		}
-	}
+	if (m_unattacked.size() == 0)		//every cell has been attacked
+		return Point(0, 0);
+
+	Point p = m_unattacked.sample(rng());	//attacks randomly if in state 3
+	markAttacked(p.r, p.c);
+	nShots++;
+	return p;
+}
 
-	return Point(0, 0);
+GoodPlayer::GoodPlayer(string name, const Game& g)
+	: Player(name, g), attackedCells(g.rows(), g.cols(), '.'), nodes(ArenaAllocator<Node>(arena)), m_grid(g.rows(), g.cols(), '.'),
+	ships(g.nShips()), shipsLeft(g.nShips()), densityGrid(g.rows(), g.cols(), 0), m_unattacked(g.rows(), g.cols()), m_fleet(g) {
+	newGame();
 }
 
-GoodPlayer::GoodPlayer(string name, const Game& g) : Player(name, g) {
+void GoodPlayer::reset(uint64_t s) {
+	Player::reset(s);
+	attackedCells.fill('.');
+	m_grid.fill('.');
+	densityGrid.fill(0);
+	m_unattacked.reset(game().rows(), game().cols());
+	newGame();
+}
+
+void GoodPlayer::newGame() {
 	totalHealth = 0;			//initializes provate members
 	currentHealth = 0;
 	m_state = 1;
@@ -624,63 +519,48 @@ GoodPlayer::GoodPlayer(string name, const Game& g) : Player(name, g) {
 	nShots = 0;
 	target = -1;
 
-	for (int i = 0; i < game().rows(); i++)			//attacked cells grind initialized to empty
-		for (int j = 0; j < game().cols(); j++) {
-			attackedCells[i][j] = '.';
-			m_grid[i][j] = '.';
-			densityGrid[i][j] = 0;
-		}
-
-	head = nullptr;
-
-	headptr = nullptr;
-	for (int i = 0; i < game().nShips(); i++) {		//creates linked list for each of the good player's ships
-		myShips* ptr = new myShips;
-		ptr->destroyed = false;
-		ptr->health = game().shipLength(i);
-		totalHealth += ptr->health;
-		currentHealth += ptr->health;
-		ptr->Id = i;
-		ptr->symbol = game().shipSymbol(i);
-		ptr->next = headptr;
-		headptr = ptr;
+	NodeList(ArenaAllocator<Node>(arena)).swap(nodes);		//drops the last game's targets before the arena takes back their memory
+	arena.reset();
+
+	for (int i = 0; i < game().nShips(); i++) {		//records each of the good player's ships
+		myShips& ship = ships[i];
+		ship.destroyed = false;
+		ship.health = game().shipLength(i);
+		totalHealth += ship.health;
+		currentHealth += ship.health;
+		ship.Id = i;
+		ship.symbol = game().shipSymbol(i);
 	}
-	shipPTR = nullptr;
+	arena.reserve(2 * totalHealth * (sizeof(Node) + 4 * sizeof(Point)));		//a game has no more targets than hits, and fits in this
+	nodes.reserve(totalHealth);
+	m_kernel.setCells(attackedCells, '.');		//finds the board's free runs once for every length
 	for (int i = 0; i < game().nShips(); i++) {
-		shipsRemaining* ptr = new shipsRemaining;
-		ptr->ID = i;
-		ptr->destroyed = false;
-		ptr->length = game().shipLength(i);
-		ptr->next = shipPTR;
-		shipPTR = ptr;
+		shipsRemaining& ship = shipsLeft[i];
+		ship.ID = i;
+		ship.destroyed = false;
+		ship.length = game().shipLength(i);
+		m_kernel.add(ship.length, 1, densityGrid);		//counts the placements of every ship on the empty board
 	}
 }
 
-GoodPlayer::~GoodPlayer() {		//deletes all dynamically allocated linked list nodes
-	while (head != nullptr) {
-		Node* temp = head;
-		head = head->next;
-		delete temp;
-	}
-
-	while (headptr != nullptr) {
-		myShips* temp = headptr;
-		headptr = headptr->next;
-		delete temp;
-	}
-
-	while (shipPTR != nullptr) {
-		shipsRemaining* temp = shipPTR;
-		shipPTR = shipPTR->next;
-		delete temp;
-	}
-
+GoodPlayer::Node& GoodPlayer::addNode() {
+	nodes.push_back(Node(arena));
+	return nodes.back();
 }
 
 bool GoodPlayer::placeShips(Board& b) {
-
-	return placeRec(b, 0);		//calls recursive function
-
+	if (!placeFleetRandomly(b, game(), m_fleet, m_placer, rng()))
+		return false;
+	const vector<ShipPlacement>& layout = m_fleet.layout;
+	for (int k = 0; k < game().nShips(); k++) {
+		Point p = layout[k].topOrLeft;
+		for (int i = 0; i < game().shipLength(k); i++) {			//records the placed ship location on its private grid
+			if (layout[k].dir == HORIZONTAL)
+				m_grid(p.r, p.c + i) = game().shipSymbol(k);
+			else m_grid(p.r + i, p.c) = game().shipSymbol(k);
+		}
+	}
+	return true;
 }
 
 Point GoodPlayer::recommendAttack() {
@@ -696,44 +576,47 @@ void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool
 
 	if (shotHit) {
 		m_state = 2;
-		Node* ptr = head;
+		Node* ptr = nullptr;
 		int temp = -1;
-		for (; ptr != nullptr; ptr = ptr->next) {		//finds current target if the last attack hit
-			temp = ptr->shipId;
-			if (temp == target)
+		for (int i = int(nodes.size()) - 1; i >= 0; i--) {		//finds current target if the last attack hit, newest first
+			temp = nodes[i].shipId;
+			if (temp == target) {
+				ptr = &nodes[i];
 				break;
+			}
 		}
 
 		if (ptr == nullptr) {		//creates a new node to attack if there is no current target
 			target = temp + 1;
-			Node* ptr1 = new Node;
-			ptr1->next = head;
+			Node* ptr1 = &addNode();
 			ptr1->pos.push_back(p);
 			ptr1->shipDestroyed = false;
 			ptr1->shipId = target;
-			head = ptr1;
 			return;
 		}
 
 		ptr->pos.push_back(p);	//pushes hit point onto node's vector
 
-
 		if (shipDestroyed) {
 			ptr->shipDestroyed = true;
 			target = -1;
 			m_state = 1;
 			int length = game().shipLength(shipId);
-			shipsRemaining* ptr2 = shipPTR;
-			for (; ptr2 != nullptr; ptr2 = ptr2->next) {
-				if (ptr2->length == length)
+			shipsRemaining* ptr2 = nullptr;
+			for (int i = int(shipsLeft.size()) - 1; i >= 0; i--) {		//the ship of that length with the highest ID
+				if (shipsLeft[i].length == length) {
+					ptr2 = &shipsLeft[i];
 					break;
+				}
 			}
-			if (ptr2 != nullptr)
+			if (ptr2 != nullptr && !ptr2->destroyed) {
+				addShipDensity(length, -1);		//removes the destroyed ship's placements from the density grid
 				ptr2->destroyed = true;
+			}
 
 			if (ptr->pos.size() > length) {		//if a destroyed ship had a smaller langth than the number of times it was hit, we hit multiple ships
-				vector<Point>::iterator it1 = ptr->pos.begin();
-				vector<Point>::iterator it2 = ptr->pos.end() - 1;
+				Points::iterator it1 = ptr->pos.begin();
+				Points::iterator it2 = ptr->pos.end() - 1;
 				Direction dir;
 				bool up;
 				bool left;
@@ -751,13 +634,11 @@ void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool
 					else left = false;
 				}
 
-				Node* ptr1 = new Node;					//creates new node containing hit locations of other ship in vector
-				ptr1->next = head;
 				if (dir == VERTICAL) {
 					for (int i = 0; i < length; i++) {
 						if (up) {
 
-							for (vector<Point>::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
+							for (Points::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
 								if (it->r == it2->r - 1) {
 									it2->r = -10;
 									it2 = it;
@@ -767,7 +648,7 @@ void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool
 							}
 						}
 						else {
-							for (vector<Point>::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
+							for (Points::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
 								if (it->r == it2->r + 1) {
 									it2->r = -10;
 									it2 = it;
@@ -780,7 +661,7 @@ void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool
 				else if (dir == HORIZONTAL) {
 					for (int i = 0; i < length; i++) {
 						if (left) {
-							for (vector<Point>::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
+							for (Points::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
 								if (it->c == it2->c - 1) {
 									it2->c = -10;
 									it2 = it;
@@ -790,7 +671,7 @@ void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool
 							}
 						}
 						else {
-							for (vector<Point>::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
+							for (Points::iterator it = ptr->pos.begin(); it != ptr->pos.end(); it++) {
 								if (it->c == it2->c + 1) {
 									it2->c = -10;
 									it2 = it;
@@ -800,21 +681,23 @@ void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool
 						}
 					}
 				}
+				size_t index = ptr - &nodes[0];
+				Node* ptr1 = &addNode();				//creates new node containing hit locations of other ship in vector
+				ptr = &nodes[index];					//adding a node can move the others
 				for (it1 = ptr->pos.begin(); it1 != ptr->pos.end(); it1++) {
 					if (it1->r != -10 && it1->c != -10)
 						ptr1->pos.push_back(*it1);
 				}
 				ptr1->shipDestroyed = false;
 				ptr1->shipId = ptr->shipId + 1;
-				head = ptr1;
 				m_state = 2;
 				target = ptr1->shipId;		//sets this ship as the current target
 				return;
 			}
 
-			for (ptr = head; ptr != nullptr; ptr = ptr->next) {		//looks for any targets that are not already destroyed
-				if (!ptr->shipDestroyed) {
-					target = ptr->shipId;
+			for (int i = int(nodes.size()) - 1; i >= 0; i--) {		//looks for any targets that are not already destroyed, newest first
+				if (!nodes[i].shipDestroyed) {
+					target = nodes[i].shipId;
 					m_state = 2;
 					break;
 				}
@@ -829,10 +712,11 @@ void GoodPlayer::recordAttackByOpponent(Point p) {
 	int counter1 = 0;
 	int counter2 = 0;
 	if (game().isValid(p.r, p.c))
-		char sym = m_grid[p.r][p.c];
+		char sym = m_grid(p.r, p.c);
 	if (sym != '.') {					//if opponent shot hit
 		currentHealth--;
-		for (myShips* ptr = headptr; ptr != nullptr; ptr = ptr->next) {		//finds hit ship
+		for (size_t k = 0; k < ships.size(); k++) {		//finds hit ship
+			myShips* ptr = &ships[k];
 			counter2++;
 			if (ptr->symbol == sym)
 			{
@@ -854,8 +738,343 @@ void GoodPlayer::recordAttackByOpponent(Point p) {
 		}
 	}*/
 
+}
+//*********************************************************************
+//  MonteCarloPlayer
+//*********************************************************************
+
+MonteCarloPlayer::MonteCarloPlayer(string nm, const Game& g)
+	: Player(nm, g), m_shot(g.rows(), g.cols()), m_hits(g.rows(), g.cols()), m_sunkAt(g.nShips(), Point(-1, -1)),
+	m_unattacked(g.rows(), g.cols()), m_samplers(NTASKS), m_choices(g.nShips()), m_nHits(0), m_anchored(g.nShips()),
+	m_keep(g.nShips()), m_fleet(g)
+{
+	for (size_t t = 0; t < m_samplers.size(); t++) {
+		m_samplers[t].used.resize(g.rows(), g.cols());
+		m_samplers[t].counts.resize(g.rows(), g.cols());
+	}
+}
+
+void MonteCarloPlayer::reset(uint64_t s)
+{
+	Player::reset(s);
+	m_shot.clear();
+	m_hits.clear();
+	fill(m_sunkAt.begin(), m_sunkAt.end(), Point(-1, -1));
+	m_unattacked.reset(game().rows(), game().cols());
+}
+
+bool MonteCarloPlayer::placeShips(Board& b)
+{
+	return placeFleetRandomly(b, game(), m_fleet, m_placer, rng());
+}
+
+bool MonteCarloPlayer::fits(Point p, int length, Direction dir) const
+{
+	if (p.r < 0 || p.c < 0)
+		return false;
+	if (dir == HORIZONTAL ? p.c + length > game().cols() : p.r + length > game().rows())
+		return false;
+	for (int i = 0; i < length; i++) {
+		int r = (dir == HORIZONTAL ? p.r : p.r + i);
+		int c = (dir == HORIZONTAL ? p.c + i : p.c);
+		if (m_shot.test(r, c) && !m_hits.test(r, c))		//a miss
+			return false;
+	}
+	return true;
+}
+
+int MonteCarloPlayer::hitsCovered(Point p, int length, Direction dir) const
+{
+	int n = 0;
+	for (int i = 0; i < length; i++)
+		if (dir == HORIZONTAL ? m_hits.test(p.r, p.c + i) : m_hits.test(p.r + i, p.c))
+			n++;
+	return n;
+}
+
+// Adds the placement to the ship's choices if it fits and agrees with
+// whether the ship is sunk
+void MonteCarloPlayer::addChoice(int shipId, Point p, Direction dir, bool sunk)
+{
+	int length = game().shipLength(shipId);
+	if (!fits(p, length, dir))
+		return;
+	Choice choice;
+	choice.placement.topOrLeft = p;
+	choice.placement.dir = dir;
+	choice.hits = hitsCovered(p, length, dir);
+	if ((choice.hits == length) == sunk)
+		m_choices[shipId].push_back(choice);
+}
+
+// Lists each ship's placements that agree with the shots, leaving out
+// only those that clash with other ships
+void MonteCarloPlayer::findChoices()
+{
+	m_order.clear();
+	for (int k = 0; k < game().nShips(); k++) {
+		int length = game().shipLength(k);
+		m_choices[k].clear();
+		Point at = m_sunkAt[k];
+		if (at.r >= 0)
+			for (int i = 0; i < length; i++) {		//every placement through the sinking shot
+				addChoice(k, Point(at.r, at.c - i), HORIZONTAL, true);
+				if (length > 1)
+					addChoice(k, Point(at.r - i, at.c), VERTICAL, true);
+			}
+		else if (k > 0 && m_sunkAt[k - 1].r < 0 && game().shipLength(k - 1) == length)
+			m_choices[k] = m_choices[k - 1];		//the same as the last ship's
+		else
+			for (int r = 0; r < game().rows(); r++)
+				for (int c = 0; c < game().cols(); c++) {
+					addChoice(k, Point(r, c), HORIZONTAL, false);
+					if (length > 1)
+						addChoice(k, Point(r, c), VERTICAL, false);
+				}
+		m_order.push_back(k);
+	}
+	for (size_t i = 1; i < m_order.size(); i++)		//sorts by the number of choices
+		for (size_t j = i; j > 0 && m_choices[m_order[j]].size() < m_choices[m_order[j - 1]].size(); j--)
+			swap(m_order[j], m_order[j - 1]);
+
+	m_nHits = int(m_hits.count());
+	m_coverLeft.assign(m_order.size() + 1, 0);
+	for (size_t j = m_order.size(); j > 0; j--) {
+		const vector<Choice>& choices = m_choices[m_order[j - 1]];
+		int most = 0;
+		for (size_t i = 0; i < choices.size(); i++)
+			most = max(most, choices[i].hits);
+		m_coverLeft[j - 1] = m_coverLeft[j] + most;
+	}
+	findAnchor();
+}
+
+namespace
+{
+	bool covers(const ShipPlacement& p, int length, int r, int c)
+	{
+		if (p.dir == HORIZONTAL)
+			return r == p.topOrLeft.r && c >= p.topOrLeft.c && c < p.topOrLeft.c + length;
+		return c == p.topOrLeft.c && r >= p.topOrLeft.r && r < p.topOrLeft.r + length;
+	}
+}
+
+// Picks a hit that every layout must cover, preferring one no sunk ship
+// can, and for each ship lists its choices that cover it.  In a layout
+// exactly one ship covers the anchor, so a draw can first pick that ship
+// and place it on the anchor.  Picking ship k uniformly and then one of its
+// a(k) anchored choices draws a layout where k covers the anchor with a
+// chance proportional to n(k) / a(k), where n(k) is its number of choices,
+// instead of the same chance for every layout; going on with a chance
+// proportional to a(k) / n(k) evens that out.
+void MonteCarloPlayer::findAnchor()
+{
+	m_anchorShips.clear();
+	if (m_nHits == 0)
+		return;
+	int nShips = game().nShips();
+	Point anchor(-1, -1);
+	for (int r = 0; r < game().rows() && anchor.r < 0; r++)
+		for (int c = 0; c < game().cols(); c++) {
+			if (!m_hits.test(r, c))
+				continue;
+			bool sunkCovers = false;
+			for (int k = 0; k < nShips && !sunkCovers; k++)
+				if (m_sunkAt[k].r >= 0)
+					for (size_t i = 0; i < m_choices[k].size() && !sunkCovers; i++)
+						sunkCovers = covers(m_choices[k][i].placement, game().shipLength(k), r, c);
+			if (anchor.r < 0 || !sunkCovers)		//the first hit, unless a later one suits better
+				anchor = Point(r, c);
+			if (!sunkCovers)
+				break;
+		}
+
+	double most = 0;
+	for (int k = 0; k < nShips; k++) {
+		m_anchored[k].clear();
+		for (size_t i = 0; i < m_choices[k].size(); i++)
+			if (covers(m_choices[k][i].placement, game().shipLength(k), anchor.r, anchor.c))
+				m_anchored[k].push_back(m_choices[k][i]);
+		if (m_anchored[k].empty())
+			continue;
+		m_anchorShips.push_back(k);
+		m_keep[k] = double(m_anchored[k].size()) / m_choices[k].size();
+		most = max(most, m_keep[k]);
+	}
+	for (size_t i = 0; i < m_anchorShips.size(); i++)
+		m_keep[m_anchorShips[i]] /= most;
+}
+
+// Draws one layout into s.used by placing every ship uniformly among its
+// choices, or returns false if two ships overlap or a hit is left
+// uncovered.  Since the ships are drawn independently and a failed draw is
+// thrown away whole, every layout that agrees with the shots is drawn with
+// the same chance.  With hits on the board, one ship is first placed on the
+// anchor hit as findAnchor describes, which keeps the chances equal while
+// wasting far fewer draws.  A draw is abandoned as soon as the ships left
+// cannot cover the hits still uncovered, which only saves the time it
+// would take to fail.
+bool MonteCarloPlayer::drawLayout(Sampler& s) const
+{
+	int anchored = -1;
+	if (m_nHits > 0) {
+		if (m_anchorShips.empty())
+			return false;
+		anchored = m_anchorShips[s.rng.nextInt(int(m_anchorShips.size()))];
+		if ((s.rng.next() >> 11) * (1.0 / 9007199254740992.0) >= m_keep[anchored])
+			return false;
+	}
+
+	s.used.clear();
+	int covered = 0;			//the ships do not overlap, so no hit is counted twice
+	for (size_t j = 0; j < m_order.size(); j++) {
+		if (covered + m_coverLeft[j] < m_nHits)
+			return false;
+		int k = m_order[j];
+		const vector<Choice>& choices = (k == anchored ? m_anchored[k] : m_choices[k]);
+		if (choices.empty())
+			return false;
+		const Choice& choice = choices[s.rng.nextInt(int(choices.size()))];
+		const ShipPlacement& p = choice.placement;
+		int length = game().shipLength(k);
+		if (s.used.anyInRun(p.topOrLeft.r, p.topOrLeft.c, length, p.dir))
+			return false;
+		s.used.setRun(p.topOrLeft.r, p.topOrLeft.c, length, p.dir);
+		covered += choice.hits;
+	}
+	return covered == m_nHits;
+}
+
+Point MonteCarloPlayer::recommendAttack()
+{
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::milliseconds(BUDGETMS);
+	findChoices();
+	for (size_t t = 0; t < m_samplers.size(); t++) {
+		m_samplers[t].rng.reseed(rng().next());		//the layouts drawn do not depend on the threads
+		m_samplers[t].counts.fill(0);
+		m_samplers[t].found = 0;
+	}
+
+	ThreadPool::shared().run(NTASKS, [this, deadline](int t) {
+		Sampler& s = m_samplers[t];
+		long long wanted = SAMPLES / NTASKS;
+		for (long long tries = 0; s.found < wanted && tries < wanted * TRIES; tries++) {
+			if (tries % 16 == 0 && chrono::steady_clock::now() >= deadline)
+				break;
+			if (!drawLayout(s))
+				continue;
+			s.found++;
+			for (int r = 0; r < game().rows(); r++)		//counts the unshot cells of the layout
+				for (int w = 0; w < s.used.wordsPerRow(); w++)
+					for (uint64_t bits = s.used.row(r)[w] & ~m_shot.row(r)[w]; bits != 0; bits &= bits - 1)
+						s.counts(r, 64 * w + Bitboard::lowestBit(bits))++;
+		}
+	});
+
+	Point best(-1, -1);
+	int bestCount = 0;
+	for (int r = 0; r < game().rows(); r++)
+		for (int c = 0; c < game().cols(); c++) {
+			int count = 0;
+			for (size_t t = 0; t < m_samplers.size(); t++)
+				count += m_samplers[t].counts(r, c);
+			if (count > bestCount) {
+				best = Point(r, c);
+				bestCount = count;
+			}
+		}
+	if (bestCount == 0)			//no layout was found in time
+		best = fallback();
+	markShot(best);
+	return best;
+}
+
+void MonteCarloPlayer::markShot(Point p)
+{
+	m_shot.set(p.r, p.c);
+	m_unattacked.remove(p.r, p.c);
+}
+
+// Returns an unattacked neighbor of a hit, or else any unattacked cell
+Point MonteCarloPlayer::fallback()
+{
+	const int dr[] = { -1, 1, 0, 0 };
+	const int dc[] = { 0, 0, -1, 1 };
+	for (int r = 0; r < game().rows(); r++)
+		for (int c = 0; c < game().cols(); c++) {
+			if (!m_hits.test(r, c))
+				continue;
+			for (int d = 0; d < 4; d++) {
+				int nr = r + dr[d], nc = c + dc[d];
+				if (game().isValid(Point(nr, nc)) && m_unattacked.contains(nr, nc))
+					return Point(nr, nc);
+			}
+		}
+	return m_unattacked.sample(rng());
+}
+
+void MonteCarloPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
+{
+	if (!validShot)
+		return;
+	if (shotHit)
+		m_hits.set(p.r, p.c);
+	if (shipDestroyed)
+		m_sunkAt[shipId] = p;
+}
 
+void MonteCarloPlayer::recordAttackByOpponent(Point /* p */)
+{
+	// MonteCarloPlayer ignores what the opponent does
 }
+
+//*********************************************************************
+//  ExactPlayer
+//*********************************************************************
+
+ExactPlayer::ExactPlayer(string nm, const Game& g) : MonteCarloPlayer(nm, g)
+{
+	vector<int> lengths;
+	for (int k = 0; k < g.nShips(); k++)
+		lengths.push_back(g.shipLength(k));
+	m_counter.setGame(g.rows(), g.cols(), lengths);
+}
+
+void ExactPlayer::reset(uint64_t s)
+{
+	MonteCarloPlayer::reset(s);
+	m_counter.reset();
+}
+
+Point ExactPlayer::recommendAttack()
+{
+	if (!m_counter.update() || m_counter.total() == 0)
+		return MonteCarloPlayer::recommendAttack();
+
+	Point best(-1, -1);
+	uint64_t bestCount = 0;
+	for (int r = 0; r < game().rows(); r++)
+		for (int c = 0; c < game().cols(); c++)
+			if (!isShot(r, c) && m_counter.occupancy(r, c) > bestCount) {
+				best = Point(r, c);
+				bestCount = m_counter.occupancy(r, c);
+			}
+	if (bestCount == 0)
+		return MonteCarloPlayer::recommendAttack();
+	markShot(best);
+	return best;
+}
+
+void ExactPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
+{
+	MonteCarloPlayer::recordAttackResult(p, validShot, shotHit, shipDestroyed, shipId);
+	if (!validShot)
+		return;
+	m_counter.recordShot(p, shotHit);
+	if (shipDestroyed)
+		m_counter.recordSunk(p, shipId);
+}
+
 //*********************************************************************
 //  createPlayer
 //*********************************************************************
@@ -863,7 +1082,7 @@ void GoodPlayer::recordAttackByOpponent(Point p) {
 Player* createPlayer(string type, string nm, const Game& g)
 {
 	static string types[] = {
-		"human", "awful", "mediocre", "good"
+		"human", "awful", "mediocre", "good", "montecarlo", "exact"
 	};
 
 	int pos;
@@ -876,6 +1095,8 @@ Player* createPlayer(string type, string nm, const Game& g)
 	case 1:  return new AwfulPlayer(nm, g);
 	case 2:  return new MediocrePlayer(nm, g);
 	case 3:  return new GoodPlayer(nm, g);
+	case 4:  return new MonteCarloPlayer(nm, g);
+	case 5:  return new ExactPlayer(nm, g);
 	default: return nullptr;
 	}
 }
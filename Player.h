@@ -1,6 +1,7 @@
 #ifndef PLAYER_INCLUDED
 #define PLAYER_INCLUDED
 
+#include "Random.h"
 #include <string>
 
 class Point;
@@ -10,15 +11,28 @@ class Game;
 class Player
 {
 public:
-	Player(std::string nm, const Game& g) : m_name(nm), m_game(g)
-	{}
+	// The player's generator is seeded from the game's, so seeding the game
+	// before creating its players makes the players reproducible too
+	Player(std::string nm, const Game& g);
 
 	virtual ~Player() {}
 
 	std::string name() const { return m_name; }
 	const Game& game() const { return m_game; }
+	void seed(uint64_t s) { m_rng.reseed(s); }
 
 	virtual bool isHuman() const { return false; }
+	// The createPlayer name of the player's type, for reports
+	virtual const char* typeName() const { return "other"; }
+	// The phase of its strategy the player is in, such as hunting for a
+	// ship or closing in on one, for profiling; 0 if it has no phases
+	virtual int phase() const { return 0; }
+
+	// Readies the player for a new game of the same Game, reseeding its
+	// generator with s and forgetting everything it learned, without
+	// reallocating.  Since a new player draws its seed from the game,
+	// reset(game().rng().next()) leaves it as a newly created one would be.
+	virtual void reset(uint64_t s) { m_rng.reseed(s); }
 
 	virtual bool placeShips(Board& b) = 0;
 	virtual Point recommendAttack() = 0;
@@ -28,9 +42,13 @@ public:
 	Player(const Player&) = delete;
 	Player& operator=(const Player&) = delete;
 
+protected:
+	Rng& rng() { return m_rng; }
+
 private:
 	std::string m_name;
 	const Game& m_game;
+	Rng m_rng;
 };
 
 Player* createPlayer(std::string type, std::string nm, const Game& g);
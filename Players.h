@@ -0,0 +1,210 @@
+#ifndef PLAYERS_INCLUDED
+#define PLAYERS_INCLUDED
+
+#include "Player.h"
+#include "Arena.h"
+#include "Bitboard.h"
+#include "CellSampler.h"
+#include "Density.h"
+#include "FleetPlacer.h"
+#include "Grid.h"
+#include "LayoutCounter.h"
+#include "globals.h"
+#include <string>
+#include <vector>
+
+// The concrete player types that createPlayer makes.  They are declared
+// here, and all but MonteCarloPlayer are final, so that code which knows
+// the types at compile time (see PlayLoop.h) calls their member functions
+// directly instead of through the vtable.  Each one's reset() clears its
+// state in place, so one player object can play any number of games.
+
+// The game's fleet as a player needs it to lay out its ships, worked out
+// when the player is created rather than every game
+struct Fleet
+{
+	Fleet(const Game& g);
+	std::vector<int> lengths;		//indexed by ship ID
+	bool fits;						//whether some layout fits on the empty board
+	std::vector<ShipPlacement> layout;	//scratch: where each ship went
+};
+
+class AwfulPlayer final : public Player
+{
+public:
+	AwfulPlayer(std::string nm, const Game& g);
+	virtual void reset(uint64_t s);
+	virtual bool placeShips(Board& b);
+	virtual Point recommendAttack();
+	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void recordAttackByOpponent(Point p);
+	virtual const char* typeName() const { return "awful"; }
+private:
+	Point m_lastCellAttacked;
+};
+
+class HumanPlayer final : public Player
+{
+public:
+	HumanPlayer(std::string nm, const Game& g);
+	virtual bool placeShips(Board& b);
+	virtual Point recommendAttack();
+	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void recordAttackByOpponent(Point p);
+	virtual bool isHuman() const { return true; }
+	virtual const char* typeName() const { return "human"; }
+};
+
+class MediocrePlayer final : public Player {
+public:
+	MediocrePlayer(std::string nm, const Game& g);
+	virtual void reset(uint64_t s);
+	virtual bool placeShips(Board& b);
+	virtual Point recommendAttack();
+	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void recordAttackByOpponent(Point p);
+	virtual const char* typeName() const { return "mediocre"; }
+	// 1 while searching, 2 while closing in on a hit
+	virtual int phase() const { return state; }
+private:
+	CellSampler unattacked;
+	Fleet m_fleet;
+	Bitboard m_taken;
+	FleetPlacer m_placer;
+	Point lastAttacked;
+	int state;
+};
+
+class GoodPlayer final : public Player {
+public:
+	GoodPlayer(std::string name, const Game& g);
+	virtual void reset(uint64_t s);
+	virtual bool placeShips(Board& b);
+	virtual Point recommendAttack();
+	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void recordAttackByOpponent(Point p);
+	Point findSpot();
+	bool checkFit(Point p, int length, Direction dir);
+	// 1 while hunting for a ship, 2 while closing in on one it has hit
+	int state() const { return m_state; }
+	virtual const char* typeName() const { return "good"; }
+	virtual int phase() const { return m_state; }
+private:
+	void newGame();
+	// Whether (r, c) is on the board and not yet attacked
+	bool isUnattacked(int r, int c) const;
+	void markAttacked(int r, int c);
+	void addShipDensity(int length, int weight);
+	Grid<char> attackedCells;
+	int m_state, nShots, oppShots, target, totalHealth, currentHealth;
+	typedef std::vector<Point, ArenaAllocator<Point>> Points;
+	struct Node {
+		Node(Arena& a) : shipId(-1), shipDestroyed(false), pos(ArenaAllocator<Point>(a)) {}
+		int shipId;
+		bool shipDestroyed;
+		Points pos;
+	};
+	typedef std::vector<Node, ArenaAllocator<Node>> NodeList;
+	// The targets, oldest first.  They and their hits live in a per-game
+	// arena, so adding one costs a pointer bump and a new game frees them
+	// all at once.
+	Arena arena;
+	NodeList nodes;
+	Node& addNode();
+	Grid<char> m_grid;
+	struct myShips {
+		int Id, health;
+		bool destroyed;
+		char symbol;
+	};
+	std::vector<myShips> ships;					//indexed by ship ID
+	struct shipsRemaining {
+		int ID, length;
+		bool destroyed;
+	};
+	std::vector<shipsRemaining> shipsLeft;		//indexed by ship ID
+	Grid<int> densityGrid;
+	PlacementDensity m_kernel;
+	CellSampler m_unattacked;
+	Fleet m_fleet;
+	FleetPlacer m_placer;
+};
+
+// Fires at the cell most often occupied in random layouts of the enemy
+// fleet that agree with every shot so far: no ship covers a miss, every hit
+// is covered, each sunk ship lies wholly on hits through the shot that sank
+// it, and no ship still afloat lies wholly on hits.  Each layout is drawn
+// by placing every ship at random among its own placements that agree with
+// the shots and starting over on any overlap or uncovered hit, so every
+// layout that agrees is equally likely.  The layouts are drawn on the
+// shared thread pool until enough are found or the move's time is up.
+class MonteCarloPlayer : public Player {
+public:
+	MonteCarloPlayer(std::string nm, const Game& g);
+	virtual void reset(uint64_t s);
+	virtual bool placeShips(Board& b);
+	virtual Point recommendAttack();
+	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual void recordAttackByOpponent(Point p);
+	virtual const char* typeName() const { return "montecarlo"; }
+protected:
+	bool isShot(int r, int c) const { return m_shot.test(r, c); }
+	void markShot(Point p);
+private:
+	enum {
+		NTASKS = 8,				//samplers per move, however many threads run them
+		SAMPLES = 1000,			//layouts wanted per move
+		BUDGETMS = 20,			//time allowed per move
+		TRIES = 200				//draws allowed per layout wanted before giving up
+	};
+	struct Sampler {			//one task's generator and scratch space
+		Rng rng;
+		Bitboard used;
+		Grid<int> counts;		//times each cell was occupied
+		long long found;
+	};
+	Bitboard m_shot, m_hits;	//misses are the shots that are not hits
+	std::vector<Point> m_sunkAt;		//indexed by ship ID; the shot that sank it, or (-1, -1)
+	CellSampler m_unattacked;
+	std::vector<Sampler> m_samplers;
+	struct Choice {
+		ShipPlacement placement;
+		int hits;				//hits it covers
+	};
+	std::vector<std::vector<Choice>> m_choices;	//indexed by ship ID; its placements that agree with the shots
+	std::vector<int> m_order;			//ship IDs, fewest choices first, so clashes are found early
+	std::vector<int> m_coverLeft;		//indexed like m_order; the most hits that ship and those after it can cover
+	int m_nHits;
+	std::vector<std::vector<Choice>> m_anchored;	//indexed by ship ID; its choices that cover the anchor hit
+	std::vector<int> m_anchorShips;		//the ships with such a choice
+	std::vector<double> m_keep;			//indexed by ship ID; the chance a draw anchored on it goes on
+	Fleet m_fleet;
+	FleetPlacer m_placer;
+
+	void findChoices();
+	void findAnchor();
+	bool drawLayout(Sampler& s) const;
+	bool fits(Point p, int length, Direction dir) const;
+	int hitsCovered(Point p, int length, Direction dir) const;
+	void addChoice(int shipId, Point p, Direction dir, bool sunk);
+	Point fallback();
+};
+
+// Fires at the cell with a ship in the most layouts of the enemy fleet that
+// agree with the shots so far, counted exactly by LayoutCounter.  While
+// the count is too big to finish (early in a game, or on a board or fleet
+// too big to count) it plays as the Monte Carlo player.  The counter's
+// tables take at most about 10 MB on a 10x10 board with the standard fleet
+// and are freed at the end of each game.
+class ExactPlayer final : public MonteCarloPlayer {
+public:
+	ExactPlayer(std::string nm, const Game& g);
+	virtual void reset(uint64_t s);
+	virtual Point recommendAttack();
+	virtual void recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId);
+	virtual const char* typeName() const { return "exact"; }
+private:
+	LayoutCounter m_counter;
+};
+
+#endif // PLAYERS_INCLUDED
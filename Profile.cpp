@@ -0,0 +1,122 @@
+#include "Profile.h"
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+using namespace std;
+
+#ifdef BATTLESHIP_PROFILE
+
+namespace
+{
+	struct Slot {
+		const char* type;
+		int phase;
+		ProfileCall call;
+		LatencyHistogram time;
+	};
+
+	// One thread's histograms, written only by that thread.  They are never
+	// freed, so a match's samples outlive its worker threads.
+	struct ThreadProfile {
+		vector<Slot*> slots;
+	};
+
+	mutex g_registryLock;
+
+	vector<ThreadProfile*>& registry()
+	{
+		static vector<ThreadProfile*> profiles;
+		return profiles;
+	}
+
+	ThreadProfile& threadProfile()
+	{
+		static thread_local ThreadProfile* t = nullptr;
+		if (t == nullptr) {
+			t = new ThreadProfile;
+			lock_guard<mutex> lock(g_registryLock);
+			registry().push_back(t);
+		}
+		return *t;
+	}
+}
+
+bool profileEnabled()
+{
+	return true;
+}
+
+void profileRecord(const char* playerType, int phase, ProfileCall call, uint64_t ns)
+{
+	ThreadProfile& t = threadProfile();
+	for (size_t i = 0; i < t.slots.size(); i++) {
+		Slot* s = t.slots[i];
+		if (s->phase == phase && s->call == call && (s->type == playerType || strcmp(s->type, playerType) == 0)) {
+			s->time.add(ns);
+			return;
+		}
+	}
+	Slot* s = new Slot;
+	s->type = playerType;
+	s->phase = phase;
+	s->call = call;
+	s->time.add(ns);
+	t.slots.push_back(s);
+}
+
+void profileSnapshot(vector<ProfileEntry>& out)
+{
+	out.clear();
+	map<tuple<string, int, int>, size_t> index;		//where each type, phase and call is in out
+	lock_guard<mutex> lock(g_registryLock);
+	for (size_t k = 0; k < registry().size(); k++) {
+		const vector<Slot*>& slots = registry()[k]->slots;
+		for (size_t i = 0; i < slots.size(); i++) {
+			tuple<string, int, int> key(slots[i]->type, slots[i]->phase, slots[i]->call);
+			if (index.find(key) == index.end()) {
+				index[key] = out.size();
+				out.push_back(ProfileEntry());
+				out.back().playerType = slots[i]->type;
+				out.back().phase = slots[i]->phase;
+				out.back().call = slots[i]->call;
+			}
+			out[index[key]].time.merge(slots[i]->time);
+		}
+	}
+
+	vector<ProfileEntry> sorted;				//puts the entries in key order
+	sorted.reserve(out.size());
+	for (map<tuple<string, int, int>, size_t>::iterator it = index.begin(); it != index.end(); ++it)
+		sorted.push_back(out[it->second]);
+	out.swap(sorted);
+}
+
+void profileReset()
+{
+	lock_guard<mutex> lock(g_registryLock);
+	for (size_t k = 0; k < registry().size(); k++) {
+		const vector<Slot*>& slots = registry()[k]->slots;
+		for (size_t i = 0; i < slots.size(); i++)
+			slots[i]->time.clear();
+	}
+}
+
+#else
+
+bool profileEnabled()
+{
+	return false;
+}
+
+void profileSnapshot(vector<ProfileEntry>& out)
+{
+	out.clear();
+}
+
+void profileReset()
+{
+}
+
+#endif // BATTLESHIP_PROFILE
@@ -0,0 +1,76 @@
+#ifndef PROFILE_INCLUDED
+#define PROFILE_INCLUDED
+
+#include "Histogram.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Per-move profiling of the players.  Building with BATTLESHIP_PROFILE
+// defined makes the turn loop in PlayLoop.h time every recommendAttack and
+// recordAttackResult call into a LatencyHistogram kept by the calling
+// thread, one per player type (Player::typeName), phase (Player::phase,
+// read before the call) and call.  A thread takes a lock only the first
+// time it records anything, and allocates only when it first sees a type,
+// phase and call; otherwise recording a call costs two clock reads and a
+// short search of the thread's own histograms.  Without BATTLESHIP_PROFILE
+// the turn loop contains no profiling code at all, and profileSnapshot
+// finds nothing.
+
+enum ProfileCall { PROFILE_RECOMMEND, PROFILE_RECORD };
+
+struct ProfileEntry
+{
+	std::string playerType;
+	int phase;
+	ProfileCall call;
+	LatencyHistogram time;		//nanoseconds per call
+};
+
+// True if this build records profiles
+bool profileEnabled();
+// Sets out to every thread's samples so far, merged, one entry for each
+// player type, phase and call seen, in that order.  Call it only while no
+// game is being played, such as after runMatch returns.
+void profileSnapshot(std::vector<ProfileEntry>& out);
+// Discards every thread's samples, under the same condition
+void profileReset();
+
+#ifdef BATTLESHIP_PROFILE
+
+// Adds one call's time to the calling thread's histogram for it
+void profileRecord(const char* playerType, int phase, ProfileCall call, uint64_t ns);
+
+// Times its own lifetime as one call
+class ProfileScope
+{
+public:
+	ProfileScope(const char* playerType, int phase, ProfileCall call)
+		: m_type(playerType), m_phase(phase), m_call(call), m_start(std::chrono::steady_clock::now()) {}
+	~ProfileScope()
+	{
+		profileRecord(m_type, m_phase, m_call,
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* m_type;
+	int m_phase;
+	ProfileCall m_call;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+// Runs the statement, timing it as the player's call
+#define PROFILE_CALL(player, call, statement) \
+	do { ProfileScope profileScope((player).typeName(), (player).phase(), call); statement; } while (0)
+
+#else
+
+#define PROFILE_CALL(player, call, statement) \
+	do { statement; } while (0)
+
+#endif // BATTLESHIP_PROFILE
+
+#endif // PROFILE_INCLUDED
@@ -0,0 +1,68 @@
+#ifndef RANDOM_INCLUDED
+#define RANDOM_INCLUDED
+
+#include <cstdint>
+
+// Expands a 64-bit value into a well mixed one (splitmix64).  Used to seed
+// generators and to derive independent seeds, such as one per game of a
+// match, from a single seed.
+inline uint64_t mixSeed(uint64_t seed, uint64_t stream = 0)
+{
+	uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// A small, fast random number generator (xoshiro256**).  Two generators
+// given the same seed produce the same sequence on every platform.
+class Rng
+{
+public:
+	explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+	void reseed(uint64_t seed)
+	{
+		for (int i = 0; i < 4; i++)
+			m_s[i] = mixSeed(seed, i);
+	}
+
+	// Returns 64 uniformly distributed random bits
+	uint64_t next()
+	{
+		uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+		uint64_t t = m_s[1] << 17;
+		m_s[2] ^= m_s[0];
+		m_s[3] ^= m_s[1];
+		m_s[1] ^= m_s[2];
+		m_s[0] ^= m_s[3];
+		m_s[2] ^= t;
+		m_s[3] = rotl(m_s[3], 45);
+		return result;
+	}
+
+	// Returns a uniformly distributed random int from 0 to limit-1, using
+	// Lemire's multiply-and-shift method, which divides only on the rare
+	// draws that would otherwise be biased
+	int nextInt(int limit)
+	{
+		uint32_t range = uint32_t(limit);
+		uint64_t m = (next() >> 32) * range;
+		uint32_t low = uint32_t(m);
+		if (low < range) {
+			uint32_t threshold = uint32_t(-range) % range;
+			while (low < threshold) {
+				m = (next() >> 32) * range;
+				low = uint32_t(m);
+			}
+		}
+		return int(m >> 32);
+	}
+
+private:
+	uint64_t m_s[4];
+
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif // RANDOM_INCLUDED
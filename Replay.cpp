@@ -0,0 +1,185 @@
+#include "Replay.h"
+#include "GameRecord.h"
+#include "GameObserver.h"
+#include "Game.h"
+#include "Board.h"
+#include "Player.h"
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+	string describe(const RecordedShot& s)
+	{
+		ostringstream out;
+		out << "player " << s.player << " at (" << s.p.r << "," << s.p.c << ") ";
+		if (!s.validShot)
+			out << "invalid";
+		else if (s.shipDestroyed)
+			out << "destroyed ship " << s.shipId;
+		else out << (s.shotHit ? "hit" : "missed");
+		return out.str();
+	}
+
+	// Compares the events of a game as it is played with its record, and
+	// notes the first difference
+	class ReplayChecker : public GameObserver
+	{
+	public:
+		ReplayChecker(const GameRecordView& rec, ReplayResult& result)
+			: m_rec(rec), m_result(result), m_first(nullptr), m_nShots(0)
+		{
+			m_result.identical = true;
+			m_result.shot = -1;
+			m_result.detail.clear();
+		}
+
+		virtual void gameStarted(const Player& p1, const Player& /* p2 */, const Board& b1, const Board& b2)
+		{
+			m_first = &p1;
+			const Board* boards[2] = { &b1, &b2 };
+			for (int i = 0; i < 2; i++)
+				for (int k = 0; k < m_rec.nShips(); k++) {
+					Point p, q;
+					Direction dir = HORIZONTAL, recDir;
+					boards[i]->shipPlacement(k, p, dir);
+					m_rec.placement(i, k, q, recDir);
+					if (m_result.identical && (p.r != q.r || p.c != q.c || dir != recDir)) {
+						ostringstream out;
+						out << "player " << i << " placed ship " << k << " at (" << p.r << "," << p.c << ") "
+							<< (dir == VERTICAL ? "vertically" : "horizontally") << ", not at (" << q.r << "," << q.c
+							<< ") " << (recDir == VERTICAL ? "vertically" : "horizontally");
+						diverge(-1, out.str());
+					}
+				}
+		}
+
+		virtual void shotFired(const Player& attacker, const Player& /* defender */, const Board& /* defenderBoard */,
+			Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
+		{
+			int n = m_nShots++;
+			if (!m_result.identical)
+				return;
+			RecordedShot s;
+			s.player = (&attacker == m_first ? 0 : 1);
+			s.p = Point(p.r & 1023, p.c & 1023);		//as the record keeps it
+			s.validShot = validShot;
+			s.shotHit = validShot && shotHit;
+			s.shipDestroyed = validShot && shipDestroyed;
+			s.shipId = (s.shipDestroyed ? shipId : -1);
+			if (n >= m_rec.nShots()) {
+				diverge(n, "the replay fired " + describe(s) + " after the recorded game ended");
+				return;
+			}
+			RecordedShot r = m_rec.shot(n);
+			if (s.player != r.player || s.p.r != r.p.r || s.p.c != r.p.c || s.validShot != r.validShot ||
+				s.shotHit != r.shotHit || s.shipDestroyed != r.shipDestroyed || s.shipId != r.shipId)
+				diverge(n, "the replay fired " + describe(s) + ", the record " + describe(r));
+		}
+
+		virtual void gameOver(const Player& winner, const Player& /* loser */,
+			const Board& /* winnerBoard */, const Board& /* loserBoard */)
+		{
+			if (!m_result.identical)
+				return;
+			if (m_nShots < m_rec.nShots())
+				diverge(m_nShots, "the replay ended before the recorded game did");
+			else if ((&winner == m_first ? 0 : 1) != m_rec.winner())
+				diverge(-1, "the replay had a different winner");
+		}
+
+	private:
+		const GameRecordView& m_rec;
+		ReplayResult& m_result;
+		const Player* m_first;
+		int m_nShots;
+
+		void diverge(int shot, const string& detail)
+		{
+			m_result.identical = false;
+			m_result.shot = shot;
+			m_result.detail = detail;
+		}
+	};
+
+}
+
+GameReplayer::GameReplayer() : m_game(nullptr)
+{
+	m_players[0] = m_players[1] = nullptr;
+}
+
+GameReplayer::~GameReplayer()
+{
+	clear();
+}
+
+void GameReplayer::clear()
+{
+	delete m_players[0];
+	delete m_players[1];
+	delete m_game;
+	m_players[0] = m_players[1] = nullptr;
+	m_game = nullptr;
+}
+
+bool GameReplayer::sameSetup(const GameRecordView& rec) const
+{
+	if (m_game == nullptr || m_game->rows() != rec.rows() || m_game->cols() != rec.cols() ||
+		m_game->nShips() != rec.nShips())
+		return false;
+	if (m_types[0] != rec.playerType(rec.firstCreated()) || m_types[1] != rec.playerType(1 - rec.firstCreated()))
+		return false;
+	for (int k = 0; k < rec.nShips(); k++)
+		if (m_game->shipLength(k) != rec.shipLength(k) || m_game->shipSymbol(k) != rec.shipSymbol(k))
+			return false;
+	return true;
+}
+
+bool GameReplayer::setUp(const GameRecordView& rec)
+{
+	clear();
+	if (rec.rows() < 1 || rec.rows() > MAXROWS || rec.cols() < 1 || rec.cols() > MAXCOLS) {
+		cout << "The recorded board is not a valid size." << endl;
+		return false;
+	}
+	m_types[0] = rec.playerType(rec.firstCreated());
+	m_types[1] = rec.playerType(1 - rec.firstCreated());
+	m_game = new Game(rec.rows(), rec.cols());
+	for (int k = 0; k < rec.nShips(); k++)
+		if (!m_game->addShip(rec.shipLength(k), rec.shipSymbol(k), string(1, rec.shipSymbol(k)))) {
+			cout << "The recorded fleet cannot be set up." << endl;
+			clear();
+			return false;
+		}
+	for (int i = 0; i < 2; i++) {
+		m_players[i] = createPlayer(m_types[i], m_types[i], *m_game);
+		if (m_players[i] == nullptr || m_players[i]->isHuman()) {
+			cout << "A " << m_types[i] << " player's games cannot be replayed." << endl;
+			clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GameReplayer::replay(const GameRecordView& rec, ReplayResult& result)
+{
+	if (!sameSetup(rec) && !setUp(rec))
+		return false;
+	m_game->seed(rec.seed());
+	m_players[0]->reset(m_game->rng().next());		//the order a new game's players draw their seeds
+	m_players[1]->reset(m_game->rng().next());
+
+	ReplayChecker checker(rec, result);
+	Player* first = m_players[rec.firstCreated()];		//player 0 of the record moved first
+	Player* second = m_players[1 - rec.firstCreated()];
+	if (m_game->play(first, second, &checker) == nullptr) {
+		result.identical = false;
+		result.shot = -1;
+		result.detail = "a player could not place its ships";
+	}
+	return true;
+}
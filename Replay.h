@@ -0,0 +1,59 @@
+#ifndef REPLAY_INCLUDED
+#define REPLAY_INCLUDED
+
+#include <string>
+
+class Game;
+class Player;
+class GameRecordView;
+
+// How a replayed game compared with its record
+struct ReplayResult
+{
+	bool identical;			//every placement, shot and the winner matched
+	// The first shot, counting from 0, that differed in its point or its
+	// result, or that one game had and the other did not; -1 if the fleets
+	// were placed differently, or if nothing differed
+	int shot;
+	std::string detail;		//what differed
+};
+
+// Re-runs recorded games (GameRecord.h) through Game::play with the
+// computer player types the records name, created in the recorded order,
+// checking every placement, every
+// recommended attack and its result, and the winner against the record.
+// A change that should not alter how the players or boards behave must
+// replay every recorded game identically; if it does not, the result
+// names the first shot that came out differently.
+//
+// A game replays exactly if it was seeded (Game::seed) just before its
+// players were created or reset, and the players' generators are their
+// only source of randomness.  The montecarlo and exact players stop
+// thinking after a time limit, so their games need not replay exactly.
+class GameReplayer
+{
+public:
+	GameReplayer();
+	~GameReplayer();
+
+	// Replays the record.  Returns false, writing why to cout, if the game
+	// cannot be replayed: a recorded type is unknown or human, or the
+	// record's fleet cannot be set up.  The game and players are kept for
+	// the next record with the same board, fleet and player types.
+	bool replay(const GameRecordView& rec, ReplayResult& result);
+
+	// We prevent a GameReplayer object from being copied or assigned
+	GameReplayer(const GameReplayer&) = delete;
+	GameReplayer& operator=(const GameReplayer&) = delete;
+
+private:
+	std::string m_types[2];			//the types of the players created first and second
+	Game* m_game;
+	Player* m_players[2];
+
+	bool sameSetup(const GameRecordView& rec) const;
+	bool setUp(const GameRecordView& rec);
+	void clear();
+};
+
+#endif // REPLAY_INCLUDED
@@ -0,0 +1,78 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int nWorkers) : m_stopping(false)
+{
+	for (int t = 0; t < nWorkers; t++)
+		m_workers.push_back(thread(&ThreadPool::workerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_work.notify_all();
+	for (size_t t = 0; t < m_workers.size(); t++)
+		m_workers[t].join();
+}
+
+ThreadPool& ThreadPool::shared()
+{
+	static ThreadPool pool(max(0, int(thread::hardware_concurrency()) - 1));
+	return pool;
+}
+
+bool ThreadPool::takeTask(Batch& b, int& i)
+{
+	if (b.next >= b.n)
+		return false;
+	i = b.next++;
+	if (b.next == b.n)		//the batch has nothing more to hand out
+		m_batches.erase(find(m_batches.begin(), m_batches.end(), &b));
+	return true;
+}
+
+void ThreadPool::runTask(Batch& b, int i, unique_lock<mutex>& lock)
+{
+	lock.unlock();
+	(*b.task)(i);
+	lock.lock();
+	if (++b.done == b.n)
+		b.finished.notify_all();
+}
+
+void ThreadPool::workerLoop()
+{
+	unique_lock<mutex> lock(m_mutex);
+	for (;;) {
+		m_work.wait(lock, [this]() { return m_stopping || !m_batches.empty(); });
+		if (m_batches.empty())		//stopping with no work left
+			return;
+		Batch& b = *m_batches.front();
+		int i;
+		if (takeTask(b, i))
+			runTask(b, i, lock);
+	}
+}
+
+void ThreadPool::run(int n, const function<void(int)>& task)
+{
+	if (n <= 0)
+		return;
+	Batch b;
+	b.task = &task;
+	b.n = n;
+	b.next = b.done = 0;
+
+	unique_lock<mutex> lock(m_mutex);
+	m_batches.push_back(&b);
+	m_work.notify_all();
+	int i;
+	while (takeTask(b, i))			//works on its own batch rather than waiting idle
+		runTask(b, i, lock);
+	b.finished.wait(lock, [&b]() { return b.done == b.n; });
+}
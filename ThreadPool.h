@@ -0,0 +1,52 @@
+#ifndef THREADPOOL_INCLUDED
+#define THREADPOOL_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that run batches of numbered tasks.  Any
+// number of threads may submit batches at once; the submitting thread
+// runs tasks of its own batch too, so a pool with no workers still works.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(int nWorkers);
+	~ThreadPool();
+
+	// Runs task(0) through task(n-1), in no particular order and possibly
+	// at the same time, and returns when all of them have finished
+	void run(int n, const std::function<void(int)>& task);
+
+	int workers() const { return int(m_workers.size()); }
+
+	// A pool with a worker for each hardware thread but the caller's
+	static ThreadPool& shared();
+
+	// We prevent a ThreadPool object from being copied or assigned
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+	struct Batch {
+		const std::function<void(int)>* task;
+		int n, next, done;
+		std::condition_variable finished;
+	};
+	std::mutex m_mutex;
+	std::condition_variable m_work;
+	std::deque<Batch*> m_batches;		//batches with tasks not yet started
+	bool m_stopping;
+	std::vector<std::thread> m_workers;
+
+	void workerLoop();
+	// Takes the next task of b, or returns false if none is left; m_mutex
+	// must be held
+	bool takeTask(Batch& b, int& i);
+	void runTask(Batch& b, int i, std::unique_lock<std::mutex>& lock);
+};
+
+#endif // THREADPOOL_INCLUDED
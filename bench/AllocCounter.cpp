@@ -0,0 +1,63 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<long long> g_allocations(0);
+	std::atomic<long long> g_bytes(0);
+	std::atomic<long long> g_liveBytes(0);
+	std::atomic<long long> g_peakBytes(0);
+
+	// Each block is preceded by a header recording its size, so that
+	// operator delete can keep the live byte count accurate
+	const size_t HEADER = alignof(std::max_align_t);
+
+	void* countedAlloc(size_t n)
+	{
+		void* p = std::malloc(n + HEADER);
+		if (p == nullptr)
+			throw std::bad_alloc();
+		*static_cast<size_t*>(p) = n;
+		g_allocations++;
+		g_bytes += n;
+		long long live = (g_liveBytes += n);
+		long long peak = g_peakBytes;
+		while (live > peak && !g_peakBytes.compare_exchange_weak(peak, live))
+			;
+		return static_cast<char*>(p) + HEADER;
+	}
+
+	void countedFree(void* p)
+	{
+		if (p == nullptr)
+			return;
+		char* block = static_cast<char*>(p) - HEADER;
+		g_liveBytes -= *reinterpret_cast<size_t*>(block);
+		std::free(block);
+	}
+}
+
+void* operator new(size_t n) { return countedAlloc(n); }
+void* operator new[](size_t n) { return countedAlloc(n); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+AllocStats allocStats()
+{
+	AllocStats s;
+	s.allocations = g_allocations;
+	s.bytes = g_bytes;
+	s.liveBytes = g_liveBytes;
+	s.peakBytes = g_peakBytes;
+	return s;
+}
+
+void resetAllocPeak()
+{
+	g_peakBytes = g_liveBytes.load();
+}
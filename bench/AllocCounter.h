@@ -0,0 +1,20 @@
+#ifndef ALLOCCOUNTER_INCLUDED
+#define ALLOCCOUNTER_INCLUDED
+
+// Linking AllocCounter.cpp into a program replaces the global operator new
+// and operator delete with versions that count every heap allocation.
+
+struct AllocStats
+{
+	long long allocations;	//calls to operator new
+	long long bytes;		//bytes requested from operator new
+	long long liveBytes;	//bytes currently allocated
+	long long peakBytes;	//largest value liveBytes has reached
+};
+
+AllocStats allocStats();
+
+// Makes the current live byte count the new peak
+void resetAllocPeak();
+
+#endif // ALLOCCOUNTER_INCLUDED
@@ -0,0 +1,35 @@
+#include "Fleets.h"
+#include "../Game.h"
+#include <string>
+
+using namespace std;
+
+vector<ShipSpec> standardFleet()
+{
+	ShipSpec ships[] = {
+		{ 5, 'A', "aircraft carrier" }, { 4, 'B', "battleship" }, { 3, 'D', "destroyer" },
+		{ 3, 'S', "submarine" }, { 2, 'P', "patrol boat" }
+	};
+	return vector<ShipSpec>(ships, ships + sizeof(ships) / sizeof(ships[0]));
+}
+
+bool addStandardShips(Game& g)
+{
+	vector<ShipSpec> fleet = standardFleet();
+	for (size_t i = 0; i < fleet.size(); i++)
+		if (!g.addShip(fleet[i].length, fleet[i].symbol, fleet[i].name))
+			return false;
+	return true;
+}
+
+bool addLargeFleet(Game& g, int nShips)
+{
+	char symbol = '!';
+	for (int k = 0; k < nShips; k++, symbol++) {
+		while (symbol == 'X' || symbol == '.' || symbol == 'o')
+			symbol++;
+		if (!g.addShip(2 + k % 4, symbol, "ship " + to_string(k)))
+			return false;
+	}
+	return true;
+}
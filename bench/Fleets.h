@@ -0,0 +1,20 @@
+#ifndef FLEETS_INCLUDED
+#define FLEETS_INCLUDED
+
+#include "../Match.h"
+#include <vector>
+
+class Game;
+
+// The fleets the benchmarks, the match runner and the example program play
+// with.  Link Fleets.cpp into a program to use them.
+
+// The five ships of the classic game: lengths 5, 4, 3, 3 and 2
+std::vector<ShipSpec> standardFleet();
+// Adds the standard fleet to g, or returns false if it does not fit
+bool addStandardShips(Game& g);
+// Adds nShips ships of lengths 2 through 5 in turn, one symbol each, or
+// returns false if one does not fit
+bool addLargeFleet(Game& g, int nShips);
+
+#endif // FLEETS_INCLUDED
@@ -0,0 +1,109 @@
+// Compares the run-length placement counting kernel in Density.cpp with
+// the cell-by-cell loop GoodPlayer used to rebuild its density grid.
+//
+// Usage: density [maxSize]
+//
+// For square boards from 10x10 up to maxSize (default 256) with 30% of the
+// cells attacked, builds the density grid of the standard fleet both ways,
+// checks that the results agree, and reports the time per grid.
+
+#include "../Density.h"
+#include "../Grid.h"
+#include "../Random.h"
+#include "../globals.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+const int LENGTHS[] = { 5, 4, 3, 3, 2 };
+const int NLENGTHS = sizeof(LENGTHS) / sizeof(LENGTHS[0]);
+
+bool checkFit(const Grid<char>& cells, int r, int c, int length, Direction dir)
+{
+	if (dir == VERTICAL && r + length > cells.rows())
+		return false;
+	if (dir == HORIZONTAL && c + length > cells.cols())
+		return false;
+	for (int i = 0; i < length; i++)
+		if ((dir == HORIZONTAL ? cells(r, c + i) : cells(r + i, c)) != '.')
+			return false;
+	return true;
+}
+
+// The loop the density kernel replaces: one checkFit per cell, length and
+// direction
+void naiveDensity(const Grid<char>& cells, Grid<int>& density)
+{
+	density.fill(0);
+	for (int s = 0; s < NLENGTHS; s++)
+		for (int r = 0; r < cells.rows(); r++)
+			for (int c = 0; c < cells.cols(); c++) {
+				if (checkFit(cells, r, c, LENGTHS[s], HORIZONTAL))
+					for (int i = 0; i < LENGTHS[s]; i++)
+						density(r, c + i)++;
+				if (checkFit(cells, r, c, LENGTHS[s], VERTICAL))
+					for (int i = 0; i < LENGTHS[s]; i++)
+						density(r + i, c)++;
+			}
+}
+
+void kernelDensity(const Grid<char>& cells, Grid<int>& density)
+{
+	static PlacementDensity kernel;
+	density.fill(0);
+	kernel.setCells(cells, '.');
+	for (int s = 0; s < NLENGTHS; s++)
+		kernel.add(LENGTHS[s], 1, density);
+}
+
+// Returns the mean nanoseconds per call of f over enough calls to take
+// about a tenth of a second
+template <typename F>
+double timePerCall(F f)
+{
+	long long n = 1;
+	for (;;) {
+		auto start = chrono::steady_clock::now();
+		for (long long i = 0; i < n; i++)
+			f();
+		double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+		if (ns > 1e8)
+			return ns / n;
+		n *= 2;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int maxSize = (argc > 1 ? stoi(argv[1]) : 256);
+	Rng rng(1);
+
+	cout << "      board    loop ns/grid  kernel ns/grid   speedup" << endl;
+	for (int size = 10; size <= maxSize; size *= 2) {
+		Grid<char> cells(size, size, '.');
+		for (int r = 0; r < size; r++)
+			for (int c = 0; c < size; c++)
+				if (rng.nextInt(10) < 3)
+					cells(r, c) = '*';
+
+		Grid<int> expected(size, size), actual(size, size);
+		naiveDensity(cells, expected);
+		kernelDensity(cells, actual);
+		for (int r = 0; r < size; r++)
+			for (int c = 0; c < size; c++)
+				if (expected(r, c) != actual(r, c)) {
+					cout << "Mismatch at (" << r << "," << c << ") on " << size << "x" << size << endl;
+					return 1;
+				}
+
+		double loop = timePerCall([&]() { naiveDensity(cells, expected); });
+		double kernel = timePerCall([&]() { kernelDensity(cells, actual); });
+		cout << setw(5) << size << "x" << left << setw(5) << size << right
+			<< setw(16) << fixed << setprecision(0) << loop
+			<< setw(16) << kernel
+			<< setw(10) << setprecision(1) << loop / kernel << "x" << endl;
+	}
+}
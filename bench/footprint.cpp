@@ -0,0 +1,85 @@
+// Reports how much memory one game takes, as Game, Board and Player objects
+// and packed as a CompactGame, and how fast compact games play.
+//
+// Usage: footprint [nGames]
+//
+// For each computer player type, plays a warm-up game, then measures the
+// bytes a 10x10 game with the standard fleet keeps live: the Game, its two
+// Boards and two players of that type, after they have played a game.
+// Then starts nGames (default 1000000) compact games of awful against
+// mediocre, all resident at once, plays them to the end, and reports the
+// memory they take, games/sec and the win rates.
+
+#include "../CompactGame.h"
+#include "../Game.h"
+#include "../Board.h"
+#include "../Player.h"
+#include "../globals.h"
+#include "AllocCounter.h"
+#include "Fleets.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Returns the bytes a game between two players of the type keeps live,
+// heap and object alike, or -1 if the game could not be played
+long long fullGameBytes(const string& type)
+{
+	long long before = allocStats().liveBytes;
+	long long bytes;
+	{
+		Game g(10, 10);
+		addStandardShips(g);
+		Player* p1 = createPlayer(type, "p1", g);
+		Player* p2 = createPlayer(type, "p2", g);
+		if (g.play(p1, p2, nullptr) == nullptr)
+			bytes = -1;
+		else bytes = allocStats().liveBytes - before + sizeof(Game) + 2 * sizeof(Board);
+		delete p1;
+		delete p2;
+	}
+	return bytes;
+}
+
+int main(int argc, char* argv[])
+{
+	long long nGames = (argc > 1 ? stoll(argv[1]) : 1000000);
+
+	const char* types[] = { "awful", "mediocre", "good", "montecarlo", "exact" };
+	cout << "10x10, standard fleet" << endl;
+	cout << "   player     bytes/game" << endl;
+	for (int t = 0; t < 5; t++) {
+		fullGameBytes(types[t]);			//fills caches shared by all games
+		cout << setw(9) << types[t] << setw(15) << fullGameBytes(types[t]) << endl;
+	}
+	cout << setw(9) << "compact" << setw(15) << sizeof(CompactGame)
+		<< "   (any two of awful, mediocre and good; fleet kept once, " << sizeof(CompactFleet) << " bytes)" << endl;
+
+	Game g(10, 10);
+	addStandardShips(g);
+	CompactFleet fleet;
+	fleet.set(g);
+	vector<CompactGame> games(nGames);
+	vector<char> started(nGames);
+	CompactPlacer scratch;
+	auto start = chrono::steady_clock::now();
+	long long failures = 0;
+	for (long long k = 0; k < nGames; k++) {
+		started[k] = games[k].start(fleet, CompactPlayer::AWFUL, CompactPlayer::MEDIOCRE, mixSeed(1, k), scratch);
+		failures += !started[k];
+	}
+	long long wins[2] = { 0, 0 };
+	for (long long k = 0; k < nGames; k++)
+		if (started[k])
+			wins[games[k].play(fleet)]++;
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << nGames << " compact games resident in " << fixed << setprecision(1)
+		<< nGames * double(sizeof(CompactGame)) / (1 << 20) << " MB: "
+		<< setprecision(0) << nGames / secs << " games/sec, awful won " << wins[0]
+		<< ", mediocre won " << wins[1] << ", " << failures << " could not place" << endl;
+}
@@ -0,0 +1,284 @@
+// Times the hot paths of Board, Game and the players one call at a time.
+//
+// Usage: microbench [jsonFile]
+//
+// On 10x10, 32x32 and 100x100 boards, with the standard five-ship fleet and
+// with a large fleet of one ship per row (up to 80 ships), measures:
+//
+//   board.place+unplace      Board::placeShip then unplaceShip of one ship
+//   board.rejectPlacement    Board::placeShip of a ship already placed, so
+//                            each call runs the bounds checks and
+//                            BoardImpl::isValidPlacement and fails
+//   board.attack             Board::attack at every cell of a full board
+//   game.shipLength          Game::shipLength
+//   game.shipName            Game::shipName
+//   good.findSpot[hunt]      GoodPlayer::findSpot while hunting (state 1)
+//   good.findSpot[target]    GoodPlayer::findSpot while closing in (state 2)
+//   good.placeShips          GoodPlayer::placeShips on a cleared board
+//   mediocre.placeShips      MediocrePlayer::placeShips on a cleared board
+//
+// and reports nanoseconds and heap allocations per call after a warm-up,
+// as a table and, if jsonFile is given, as JSON for comparing runs.
+// findSpot is timed call by call during whole games against a board, with
+// the clock's own cost subtracted.  (GoodPlayer no longer has the
+// recursive placeRec; its fleet is placed by FleetPlacer, which
+// good.placeShips covers.  Its random third state is disabled.)
+
+#include "../Game.h"
+#include "../Board.h"
+#include "../Player.h"
+#include "../Players.h"
+#include "../globals.h"
+#include "AllocCounter.h"
+#include "Fleets.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+const double MINSECONDS = 0.05;		//time each benchmark runs for, at least
+
+struct Result
+{
+	string name;
+	int rows, cols, nShips;
+	long long ops;
+	double ns;				//per op
+	double allocs;			//per op
+};
+
+vector<Result> g_results;
+volatile long long g_sink;		//keeps the optimizer from dropping the work
+
+void report(const string& name, const Game& g, long long ops, double secs, long long allocs)
+{
+	Result r = { name, g.rows(), g.cols(), g.nShips(), ops, secs * 1e9 / ops, double(allocs) / ops };
+	g_results.push_back(r);
+	cout << left << setw(24) << name << right << setw(5) << r.rows << "x" << left << setw(5) << r.cols << right
+		<< setw(6) << r.nShips << setw(12) << ops << setw(12) << fixed << setprecision(1) << r.ns
+		<< setw(12) << setprecision(3) << r.allocs << endl;
+}
+
+// Calls batch, which does opsPerBatch operations, until MINSECONDS have
+// passed, after one uncounted call to warm up
+template <typename F>
+void measure(const string& name, const Game& g, long long opsPerBatch, F batch)
+{
+	batch();
+	long long ops = 0;
+	AllocStats before = allocStats();
+	Clock::time_point start = Clock::now();
+	double secs;
+	do {
+		batch();
+		ops += opsPerBatch;
+		secs = chrono::duration<double>(Clock::now() - start).count();
+	} while (secs < MINSECONDS);
+	report(name, g, ops, secs, allocStats().allocations - before.allocations);
+}
+
+// The cost of reading the clock twice, to take out of per-call timings
+double clockOverhead()
+{
+	const int N = 100000;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < N; i++) {
+		Clock::time_point a = Clock::now();
+		Clock::time_point b = Clock::now();
+		g_sink += (b - a).count();
+	}
+	return chrono::duration<double>(Clock::now() - start).count() / N;
+}
+
+void boardBenchmarks(const Game& g, Player& placer)
+{
+	Board b(g);
+	int shipId = g.nShips() - 1;
+	int length = g.shipLength(shipId);
+
+	// Every spot the last ship can take on an empty board
+	vector<Point> spots;
+	vector<Direction> dirs;
+	for (int r = 0; r < g.rows(); r++)
+		for (int c = 0; c < g.cols(); c++) {
+			if (c + length <= g.cols()) {
+				spots.push_back(Point(r, c));
+				dirs.push_back(HORIZONTAL);
+			}
+			if (r + length <= g.rows()) {
+				spots.push_back(Point(r, c));
+				dirs.push_back(VERTICAL);
+			}
+		}
+	measure("board.place+unplace", g, spots.size(), [&]() {
+		for (size_t i = 0; i < spots.size(); i++) {
+			b.placeShip(spots[i], shipId, dirs[i]);
+			b.unplaceShip(spots[i], shipId, dirs[i]);
+		}
+	});
+
+	b.clear();
+	placer.placeShips(b);
+	measure("board.rejectPlacement", g, spots.size(), [&]() {
+		long long placed = 0;
+		for (size_t i = 0; i < spots.size(); i++)
+			placed += b.placeShip(spots[i], shipId, dirs[i]);
+		g_sink += placed;
+	});
+
+	// Each batch shoots every cell of a freshly placed fleet, in an order
+	// fixed in advance; only the attacks are timed
+	vector<Point> order;
+	for (int r = 0; r < g.rows(); r++)
+		for (int c = 0; c < g.cols(); c++)
+			order.push_back(Point(r, c));
+	for (size_t i = order.size() - 1; i > 0; i--)
+		swap(order[i], order[g.rng().nextInt(int(i) + 1)]);
+	double secs = 0;
+	long long ops = 0, allocs = 0;
+	for (int round = 0; round == 0 || secs < MINSECONDS; round++) {		//the first round warms up
+		b.clear();
+		placer.placeShips(b);
+		long long a0 = allocStats().allocations;
+		Clock::time_point start = Clock::now();
+		long long hits = 0;
+		for (size_t i = 0; i < order.size(); i++) {
+			bool hit, destroyed;
+			int id;
+			b.attack(order[i], hit, destroyed, id);
+			hits += hit;
+		}
+		double t = chrono::duration<double>(Clock::now() - start).count();
+		g_sink += hits;
+		if (round > 0) {
+			secs += t;
+			ops += order.size();
+			allocs += allocStats().allocations - a0;
+		}
+	}
+	report("board.attack", g, ops, secs, allocs);
+}
+
+void gameBenchmarks(const Game& g)
+{
+	int n = g.nShips();
+	measure("game.shipLength", g, n, [&]() {
+		long long sum = 0;
+		for (int k = 0; k < n; k++)
+			sum += g.shipLength(k);
+		g_sink += sum;
+	});
+	measure("game.shipName", g, n, [&]() {
+		long long sum = 0;
+		for (int k = 0; k < n; k++)
+			sum += g.shipName(k).size();
+		g_sink += sum;
+	});
+}
+
+// Plays whole games of a good player against a board, timing each
+// findSpot call and sorting it by the state the player was in
+void findSpotBenchmarks(Game& g, Player& placer, double overhead)
+{
+	GoodPlayer p("good", g);
+	Board b(g);
+	double secs[3] = { 0, 0, 0 };
+	long long ops[3] = { 0, 0, 0 }, allocs[3] = { 0, 0, 0 };
+	for (int game = 0; game == 0 || secs[1] + secs[2] < 2 * MINSECONDS; game++) {
+		p.reset(g.rng().next());
+		b.clear();
+		placer.placeShips(b);
+		while (!b.allShipsDestroyed()) {
+			int s = p.state();
+			long long a0 = allocStats().allocations;
+			Clock::time_point start = Clock::now();
+			Point spot = p.findSpot();
+			Clock::time_point end = Clock::now();
+			if (game > 0 && s >= 1 && s <= 2) {		//the first game warms up
+				secs[s] += chrono::duration<double>(end - start).count() - overhead;
+				ops[s]++;
+				allocs[s] += allocStats().allocations - a0;
+			}
+			bool hit, destroyed;
+			int id;
+			bool valid = b.attack(spot, hit, destroyed, id);
+			p.recordAttackResult(spot, valid, hit, destroyed, id);
+		}
+	}
+	const char* names[3] = { "", "good.findSpot[hunt]", "good.findSpot[target]" };
+	for (int s = 1; s <= 2; s++)
+		if (ops[s] > 0)
+			report(names[s], g, ops[s], secs[s], allocs[s]);
+}
+
+void placeBenchmark(const string& name, const Game& g, Player& p)
+{
+	Board b(g);
+	measure(name, g, 1, [&]() {
+		b.clear();
+		if (!p.placeShips(b))
+			cout << name << " could not place the fleet" << endl;
+	});
+}
+
+void run(int size, bool largeFleet, double overhead)
+{
+	Game g(size, size);
+	int nShips = (size < 80 ? size : 80);
+	if (!(largeFleet ? addLargeFleet(g, nShips) : addStandardShips(g))) {
+		cout << "fleet does not fit on " << size << "x" << size << endl;
+		return;
+	}
+	g.seed(size * 2 + largeFleet);
+
+	MediocrePlayer mediocre("mediocre", g);
+	GoodPlayer good("good", g);
+	boardBenchmarks(g, mediocre);
+	gameBenchmarks(g);
+	findSpotBenchmarks(g, mediocre, overhead);
+	placeBenchmark("good.placeShips", g, good);
+	placeBenchmark("mediocre.placeShips", g, mediocre);
+}
+
+// Writes the results as a JSON object with one entry per measurement
+bool writeJson(const string& path)
+{
+	ofstream out(path);
+	if (!out) {
+		cout << "Cannot create " << path << endl;
+		return false;
+	}
+	out << "{\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < g_results.size(); i++) {
+		const Result& r = g_results[i];
+		out << "    { \"name\": \"" << r.name << "\", \"rows\": " << r.rows << ", \"cols\": " << r.cols
+			<< ", \"ships\": " << r.nShips << ", \"ops\": " << r.ops
+			<< fixed << setprecision(2) << ", \"ns_per_op\": " << r.ns
+			<< setprecision(4) << ", \"allocs_per_op\": " << r.allocs << " }"
+			<< (i + 1 < g_results.size() ? "," : "") << "\n";
+	}
+	out << "  ]\n}\n";
+	return bool(out);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 2 || (argc == 2 && argv[1][0] == '-')) {		//checked before the runs, which take a while
+		cout << "Usage: microbench [jsonFile]" << endl;
+		return 1;
+	}
+	double overhead = clockOverhead();
+	cout << "clock overhead " << fixed << setprecision(1) << overhead * 1e9 << " ns per timed call" << endl;
+	cout << "benchmark                   board ships         ops       ns/op   allocs/op" << endl;
+	int sizes[] = { 10, 32, 100 };
+	for (int largeFleet = 0; largeFleet < 2; largeFleet++)
+		for (int i = 0; i < 3; i++)
+			run(sizes[i], largeFleet == 1, overhead);
+	if (argc > 1 && !writeJson(argv[1]))
+		return 1;
+}
@@ -0,0 +1,125 @@
+// Measures how game throughput and memory scale with board size.
+//
+// Usage: scaling [player1 [player2 [maxSize]]]
+//
+// For each square board size from 10x10 up to maxSize (default 1024), plays
+// a batch of games between two computer players (default awful vs awful)
+// with the standard five-ship fleet and with a large fleet of one ship per
+// row (up to 80 ships), and reports games/sec and the heap allocations and
+// bytes allocated per game once the players are warmed up.  A steady-state
+// game must allocate nothing: if any board size shows an allocation after
+// warm-up, the program says so and exits with status 1.
+
+#include "../Game.h"
+#include "../Board.h"
+#include "../Player.h"
+#include "../GameObserver.h"
+#include "../globals.h"
+#include "AllocCounter.h"
+#include "Fleets.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+// Counts the shots fired in a game
+class ShotCounter : public GameObserver
+{
+public:
+	ShotCounter() : shots(0) {}
+	virtual void shotFired(const Player&, const Player&, const Board&, Point, bool, bool, bool, int) { shots++; }
+	long long shots;
+};
+
+// Returns false if a game after the first allocated
+bool run(int size, bool largeFleet, const string& type1, const string& type2)
+{
+	Game g(size, size);
+	int nShips = (size < 80 ? size : 80);
+	if (!(largeFleet ? addLargeFleet(g, nShips) : addStandardShips(g))) {
+		cout << "fleet does not fit on " << size << "x" << size << endl;
+		return true;
+	}
+
+	// Aim for roughly the same number of shots at every size
+	long long cells = (long long)size * size;
+	int nGames = int(4000000 / cells);
+	if (nGames < 2)
+		nGames = 2;
+
+	// The players are made once and reset for each game, as a match worker
+	// does; the first game warms them up and is not counted
+	AllocStats before = allocStats();
+	resetAllocPeak();
+	Player* p1 = createPlayer(type1, "p1", g);
+	Player* p2 = createPlayer(type2, "p2", g);
+	long long shots = 0;
+	AllocStats warm = before;
+	auto start = chrono::steady_clock::now();
+	for (int k = 0; k <= nGames; k++) {
+		if (k == 1) {
+			warm = allocStats();
+			start = chrono::steady_clock::now();
+		}
+		p1->reset(g.rng().next());
+		p2->reset(g.rng().next());
+		ShotCounter counter;
+		if (g.play(p1, p2, &counter) == nullptr) {
+			cout << "players could not place their ships" << endl;
+			delete p1;
+			delete p2;
+			return true;
+		}
+		if (k > 0)
+			shots += counter.shots;
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	AllocStats after = allocStats();
+	delete p1;
+	delete p2;
+
+	cout << setw(5) << size << "x" << left << setw(5) << size << right
+		<< setw(6) << g.nShips()
+		<< setw(8) << nGames
+		<< setw(14) << fixed << setprecision(1) << nGames / secs
+		<< setw(14) << setprecision(1) << shots / secs / 1e6
+		<< setw(16) << setprecision(2) << double(after.allocations - warm.allocations) / nGames
+		<< setw(16) << (after.bytes - warm.bytes) / nGames
+		<< setw(16) << after.peakBytes - before.liveBytes << endl;
+	return after.allocations == warm.allocations;
+}
+
+int main(int argc, char* argv[])
+{
+	string type1 = (argc > 1 ? argv[1] : "awful");
+	string type2 = (argc > 2 ? argv[2] : "awful");
+	int maxSize = (argc > 3 ? stoi(argv[3]) : MAXROWS);
+
+	Game probe(1, 1);
+	Player* p = createPlayer(type1, "probe", probe);
+	Player* q = createPlayer(type2, "probe", probe);
+	bool ok = (p != nullptr && q != nullptr && !p->isHuman() && !q->isHuman());
+	delete p;
+	delete q;
+	if (!ok) {
+		cout << "Both players must be computer player types" << endl;
+		return 1;
+	}
+
+	cout << type1 << " vs " << type2 << endl;
+	cout << "      board ships   games     games/sec  Mshots/sec    allocs/game      bytes/game      peak bytes" << endl;
+	bool steady = true;
+	for (int largeFleet = 0; largeFleet < 2; largeFleet++)
+		for (int size = 10; size <= maxSize; size *= 2) {
+			if (!run(size, largeFleet == 1, type1, type2))
+				steady = false;
+			if (size < maxSize && size * 2 > maxSize)
+				size = maxSize / 2;
+		}
+	if (!steady) {
+		cout << "Games allocated after the players were warmed up" << endl;
+		return 1;
+	}
+}
@@ -0,0 +1,104 @@
+// Builds win-rate tables for the awful and mediocre strategies with the
+// batched simulator in GameBatch.h.
+//
+// Usage: winrates [nGames]
+//
+// For square boards from 6x6 to 11x11 with the standard fleet, plays
+// about nGames (default 100000) games of each matchup, in whole batches,
+// half with each player moving first, and prints how often the row player beat the column
+// player, with the games/sec the batches reached.  Build with -mavx2 or
+// -msse4.1 (or -march=native) to resolve the shots with SIMD instructions.
+// On the first board, the first two batches of every matchup, one with
+// each player moving first, are checked against CompactGame, game by game.
+
+#include "../GameBatch.h"
+#include "../CompactGame.h"
+#include "../Game.h"
+#include "../globals.h"
+#include "Fleets.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+const int BATCH = 4096;		//games stepped in lockstep
+
+// Returns true if every game of the batch ended as the compact game with
+// the same seed does
+bool agreesWithCompact(const CompactFleet& f, const GameBatch& batch, CompactPlayer::Kind k0,
+	CompactPlayer::Kind k1, uint64_t seed)
+{
+	CompactPlacer scratch;
+	for (int g = 0; g < batch.size(); g++) {
+		CompactGame game;
+		int winner = (game.start(f, k0, k1, mixSeed(seed, g), scratch) ? game.play(f) : -1);
+		if (winner != batch.winner(g))
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	long long nGames = (argc > 1 ? stoll(argv[1]) : 100000);
+	long long nBatches = (nGames + 2 * BATCH - 1) / (2 * BATCH) * 2;		//an even number, so each player moves first equally often
+	const CompactPlayer::Kind kinds[] = { CompactPlayer::AWFUL, CompactPlayer::MEDIOCRE };
+	const char* names[] = { "awful", "mediocre" };
+
+	cout << "shots resolved with " << GameBatch::instructionSet() << endl;
+	int checkedSize = 0;			//the board whose batches are checked
+	for (int size = 6; size <= 11; size++) {
+		Game g(size, size);
+		if (!addStandardShips(g))
+			continue;
+		CompactFleet fleet;
+		fleet.set(g);
+		GameBatch batch(fleet, BATCH);
+		if (checkedSize == 0)
+			checkedSize = size;
+
+		cout << endl << size << "x" << size << ": row player's wins" << endl;
+		cout << setw(10) << "";
+		for (int j = 0; j < 2; j++)
+			cout << setw(10) << names[j];
+		cout << endl;
+		long long played = 0;
+		double checkSecs = 0;				//time spent checking, left out of the rate
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < 2; i++) {
+			cout << setw(10) << names[i];
+			for (int j = 0; j < 2; j++) {
+				long long wins = 0, games = 0;
+				for (long long n = 0; n < nBatches; n++) {
+					int order = int(n % 2);				//alternates which player moves first
+					uint64_t seed = mixSeed(size, n);
+					CompactPlayer::Kind first = kinds[order == 0 ? i : j], second = kinds[order == 0 ? j : i];
+					int failures = batch.start(first, second, seed);
+					batch.play();
+					if (size == checkedSize && n < 2) {
+						cout.flush();
+						auto checkStart = chrono::steady_clock::now();
+						bool agrees = agreesWithCompact(fleet, batch, first, second, seed);
+						checkSecs += chrono::duration<double>(chrono::steady_clock::now() - checkStart).count();
+						if (!agrees) {
+							cout << "batch disagrees with CompactGame (" << names[order == 0 ? i : j]
+								<< " moving first against " << names[order == 0 ? j : i] << ")" << endl;
+							return 1;
+						}
+					}
+					for (int k = 0; k < batch.size(); k++)
+						if (batch.winner(k) >= 0)
+							wins += (batch.winner(k) == order);
+					games += batch.size() - failures;
+				}
+				played += games;
+				cout << setw(9) << fixed << setprecision(1) << 100.0 * wins / games << "%";
+			}
+			cout << endl;
+		}
+		double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count() - checkSecs;
+		cout << setprecision(0) << played / secs << " games/sec" << endl;
+	}
+}
@@ -1,10 +1,11 @@
 #ifndef GLOBALS_INCLUDED
 #define GLOBALS_INCLUDED
 
+#include "Random.h"
 #include <random>
 
-const int MAXROWS = 10;
-const int MAXCOLS = 10;
+const int MAXROWS = 1024;
+const int MAXCOLS = 1024;
 
 enum Direction {
 	HORIZONTAL, VERTICAL
@@ -19,13 +20,20 @@ public:
 	int c;
 };
 
-// Return a uniformly distributed random int from 0 to limit-1
+// Return a seed that differs from run to run
+inline uint64_t randomSeed()
+{
+	std::random_device rd;
+	return (uint64_t(rd()) << 32) ^ rd();
+}
+
+// Return a uniformly distributed random int from 0 to limit-1.
+// Every thread draws from its own unseeded generator; code that must be
+// reproducible uses the generators owned by Game and Player instead.
 inline int randInt(int limit)
 {
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
-	std::uniform_int_distribution<> distro(0, limit - 1);
-	return distro(generator);
+	static thread_local Rng generator(randomSeed());
+	return generator.nextInt(limit);
 }
 
 #endif // GLOBALS_INCLUDED
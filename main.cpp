@@ -1,15 +1,14 @@
 #include "Game.h"
 #include "Player.h"
+#include "Match.h"
+#include "globals.h"
+#include "bench/Fleets.h"
 #include <iostream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
-bool addStandardShips(Game& g)
-{
-	return g.addShip(5, 'A', "aircraft carrier") &&g.addShip(4, 'B', "battleship") &&g.addShip(3, 'D', "destroyer") &&g.addShip(3, 'S', "submarine") &&g.addShip(2, 'P', "patrol boat");
-}
-
 int main()
 {
 	const int NTRIALS = 100;
@@ -51,24 +50,18 @@ int main()
 	}
 	else if (line[0] == '3')
 	{
-		int nMediocreWins = 0;
-
-		for (int k = 1; k <= NTRIALS; k++)
-		{
-			cout << "============================= Game " << k
-				<< " =============================" << endl;
-			Game g(10, 10);
-			addStandardShips(g);
-			Player* p1 = createPlayer("good", "Awful Audrey", g);
-			Player* p2 = createPlayer("mediocre", "Mediocre Mimi", g);
-			Player* winner = (k % 2 == 1 ?
-				g.play(p1, p2, false) : g.play(p2, p1, false));
-			if (winner == p2)
-				nMediocreWins++;
-			delete p1;
-			delete p2;
-		}
-		cout << "The mediocre player won " << nMediocreWins << " out of "
+		// Play the games on all cores without any console output
+		MatchConfig config;
+		config.rows = 10;
+		config.cols = 10;
+		config.fleet = standardFleet();
+		config.player1 = "good";
+		config.player2 = "mediocre";
+		config.nGames = NTRIALS;
+		config.seed = randomSeed();
+		MatchResult result;
+		runMatch(config, result);
+		cout << "The mediocre player won " << result.wins[1] << " out of "
 			<< NTRIALS << " games." << endl;
 		// We'd expect a mediocre player to win most of the games against
 		// an awful player.  Similarly, a good player should outperform
@@ -0,0 +1,196 @@
+// Plays a match between two computer players without any interaction and
+// reports its throughput, per-move latency and win rates.
+//
+// Usage: matchrunner [options] player1 player2
+//
+//   -r rows, -c cols    board size (default 10x10)
+//   -f fleet            ship lengths separated by commas, such as 5,4,3,3,2,
+//                       or "standard" (the default)
+//   -n games            games to play (default 1000)
+//   -t threads          threads to play them on (default one per core, but
+//                       fewer for exact players: see defaultThreads)
+//   -s seed             match seed (default unpredictable)
+//   --no-latency        do not time the moves, for the highest throughput
+//
+// The players are createPlayer type names other than human.  player1 moves
+// first in even-numbered games and player2 in odd-numbered ones.  A move is
+// timed from the start of the player's turn through its shot and both
+// players recording it.  Built with BATTLESHIP_PROFILE defined, it also
+// reports how long each player type's recommendAttack and
+// recordAttackResult calls took in each phase of its strategy.  The program
+// exits with status 1 if the arguments or the match setup are invalid.
+//
+// Build it like the benchmarks, from this file, bench/Fleets.cpp and the
+// game sources other than main.cpp.
+
+#include "../Match.h"
+#include "../Histogram.h"
+#include "../Profile.h"
+#include "../globals.h"
+#include "../bench/Fleets.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+void usage()
+{
+	cout << "Usage: matchrunner [-r rows] [-c cols] [-f fleet] [-n games] [-t threads] [-s seed] [--no-latency] player1 player2" << endl;
+}
+
+// Sets fleet from a list of lengths, giving the ships the symbols A, B, C
+// and so on, or returns false if the list is malformed
+bool parseFleet(const string& spec, vector<ShipSpec>& fleet)
+{
+	if (spec == "standard") {
+		fleet = standardFleet();
+		return true;
+	}
+	fleet.clear();
+	istringstream in(spec);
+	string item;
+	char symbol = 'A';
+	while (getline(in, item, ',')) {
+		ShipSpec s;
+		istringstream number(item);
+		if (!(number >> s.length) || s.length <= 0)
+			return false;
+		while (symbol == 'X' || symbol == 'o' || symbol == '.')
+			symbol++;
+		s.symbol = symbol++;
+		s.name = string("ship ") + s.symbol;
+		fleet.push_back(s);
+	}
+	return !fleet.empty();
+}
+
+// The threads to play a match on when -t is not given: one per core,
+// except that each thread plays a game at a time, and an exact player's
+// layout counts can take about 10 MB a game on a 10x10 board, so matches
+// with exact players run on as many threads as fit in about 1 GB
+int defaultThreads(const MatchConfig& config)
+{
+	const long long EXACTBYTES = 12LL << 20;		//an exact player's tables, at most
+	const long long MEMORY = 1LL << 30;			//what the exact players' tables may take in all
+	int threads = max(1, int(thread::hardware_concurrency()));
+	int exact = (config.player1 == "exact") + (config.player2 == "exact");
+	if (exact > 0 && threads > MEMORY / (exact * EXACTBYTES))
+		threads = int(max(1LL, MEMORY / (exact * EXACTBYTES)));
+	return threads;
+}
+
+bool parseNumber(const char* text, long long& n)
+{
+	istringstream in(text);
+	return (in >> n) && in.eof();
+}
+
+// Writes the time the players' calls took, by player type and phase, as
+// recorded in a build with BATTLESHIP_PROFILE
+void printProfile()
+{
+	vector<ProfileEntry> entries;
+	profileSnapshot(entries);
+	cout << "player        phase  call                    calls    mean ns     p50 ns     p99 ns     max ns" << endl;
+	for (size_t i = 0; i < entries.size(); i++) {
+		const ProfileEntry& e = entries[i];
+		cout << left << setw(12) << e.playerType << right << setw(7) << e.phase << "  " << left
+			<< setw(20) << (e.call == PROFILE_RECOMMEND ? "recommendAttack" : "recordAttackResult") << right
+			<< setw(9) << e.time.count() << setw(11) << fixed << setprecision(0) << e.time.mean()
+			<< setw(11) << e.time.percentile(0.5) << setw(11) << e.time.percentile(0.99)
+			<< setw(11) << e.time.max() << endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	MatchConfig config;
+	config.fleet = standardFleet();
+	config.nGames = 1000;
+	config.seed = randomSeed();
+	config.timeMoves = true;
+	vector<string> players;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--no-latency") {
+			config.timeMoves = false;
+			continue;
+		}
+		if (arg.size() != 2 || arg[0] != '-') {
+			players.push_back(arg);
+			continue;
+		}
+		if (i + 1 >= argc) {
+			usage();
+			return 1;
+		}
+		const char* value = argv[++i];
+		long long n;
+		bool ok;
+		switch (arg[1]) {
+		case 'r':  ok = parseNumber(value, n); config.rows = int(n); break;
+		case 'c':  ok = parseNumber(value, n); config.cols = int(n); break;
+		case 'n':  ok = parseNumber(value, n) && n > 0; config.nGames = n; break;
+		case 't':  ok = parseNumber(value, n) && n >= 0; config.nThreads = int(n); break;
+		case 's':  ok = parseNumber(value, n); config.seed = uint64_t(n); break;
+		case 'f':  ok = parseFleet(value, config.fleet); break;
+		default:   ok = false; break;
+		}
+		if (!ok) {
+			cout << "Bad value for " << arg << ": " << value << endl;
+			usage();
+			return 1;
+		}
+	}
+	if (players.size() != 2) {
+		usage();
+		return 1;
+	}
+	config.player1 = players[0];
+	config.player2 = players[1];
+	if (config.nThreads == 0)
+		config.nThreads = defaultThreads(config);
+
+	MatchResult result;
+	profileReset();
+	if (!runMatch(config, result)) {
+		cout << "Cannot play " << config.player1 << " against " << config.player2 << " on a "
+			<< config.rows << "x" << config.cols << " board with that fleet" << endl;
+		return 1;
+	}
+
+	long long played = result.wins[0] + result.wins[1];
+	cout << config.player1 << " vs " << config.player2 << " on " << config.rows << "x" << config.cols
+		<< " with " << config.fleet.size() << " ships, seed " << config.seed << endl;
+	cout << config.nGames << " games in " << fixed << setprecision(3) << result.seconds << " s: "
+		<< setprecision(1) << config.nGames / result.seconds << " games/sec";
+	if (result.failures > 0)
+		cout << ", " << result.failures << " could not be played";
+	cout << endl;
+	cout << "player          wins   win rate  mean shots to win";
+	if (config.timeMoves)
+		cout << "      moves  mean ns/move   p99 ns/move";
+	cout << endl;
+	for (int w = 0; w < 2; w++) {
+		const vector<long long>& hist = result.shotsToWin[w];
+		long long shots = 0;
+		for (size_t n = 0; n < hist.size(); n++)
+			shots += hist[n] * (long long)n;
+		cout << left << setw(12) << (w == 0 ? config.player1 : config.player2) << right
+			<< setw(8) << result.wins[w]
+			<< setw(10) << setprecision(2) << (played > 0 ? 100.0 * result.wins[w] / played : 0) << "%"
+			<< setw(19) << setprecision(1) << (result.wins[w] > 0 ? double(shots) / result.wins[w] : 0);
+		if (config.timeMoves)
+			cout << setw(11) << result.moveTime[w].count()
+				<< setw(14) << setprecision(0) << result.moveTime[w].mean()
+				<< setw(14) << result.moveTime[w].percentile(0.99);
+		cout << endl;
+	}
+	if (profileEnabled())
+		printProfile();
+}